@@ -0,0 +1,28 @@
+// Clip table of SpriteEffects and the closed form of the playback.
+// Mirrors SpriteEffects::ClipData (std430 layout) and Animation::getStepAt / getFrameAt.
+
+struct Clip
+{
+    uint  first;    // Into the frame table
+    uint  duration; // In frames
+    float delay;    // Milliseconds per frame, at least 1
+    uint  padding;
+};
+
+layout (std430, binding = 2) readonly buffer Clips
+{
+    Clip clips[];
+};
+
+uint getStepAt(Clip clip, float elapsed)
+{
+    return elapsed <= 0.0f ? 0u : uint(floor(elapsed / clip.delay));
+}
+
+uint getFrameAt(Clip clip, float elapsed, bool isLooped, bool isReversed)
+{
+    uint step  = getStepAt(clip, elapsed);
+    uint frame = isLooped ? step % clip.duration : min(step, clip.duration - 1u);
+
+    return clip.first + (isReversed ? clip.duration - 1u - frame : frame);
+}
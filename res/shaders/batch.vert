@@ -0,0 +1,43 @@
+#version 460 core
+
+// Vertex stage of the sprite paths, built through ShaderVariants.
+// By default quads arrive already transformed by SpriteBatch, only the view is applied here.
+// INSTANCED: one instance per sprite, the mesh is built from gl_VertexID and the frame table of SpriteManager,
+// drawn as an 8-vertex triangle fan over the frame's outline, padded with its last point.
+
+#include "frame.glsl"
+
+#ifdef INSTANCED
+#include "sprite_frames.glsl"
+
+layout (location = 0) in vec4 basis; // x axis in xy, y axis in zw
+layout (location = 1) in vec2 origin;
+layout (location = 2) in uint frameIndex;
+layout (location = 3) in vec4 color;
+#else
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 texCoords;
+layout (location = 2) in vec4 color;
+#endif
+
+out vec2 tex_coord;
+out vec4 tint;
+
+void main()
+{
+#ifdef INSTANCED
+    SpriteFrame frame = frames[frameIndex];
+
+    vec2 local = getOutlinePoint(frame, gl_VertexID);
+    vec2 world = origin + basis.xy * local.x + basis.zw * local.y;
+
+    gl_Position = ViewProjection * vec4(world.x, world.y, 0.0f, 1.0f);
+
+    tex_coord = mix(frame.texCoords.xy, frame.texCoords.zw, local / frame.size);
+#else
+    gl_Position = ViewProjection * vec4(position.x, position.y, 0.0f, 1.0f);
+
+    tex_coord = texCoords;
+#endif
+    tint = color;
+}
@@ -0,0 +1,63 @@
+#version 460 core
+
+// Self-animating sprites of SpriteEffects: each instance only holds its placement and when it started,
+// the frame comes from the Time of the FrameData block and the clip table. Drawn as an 8-vertex
+// triangle fan over the frame's outline, like the INSTANCED variant of batch.vert.
+
+#include "frame.glsl"
+#include "sprite_frames.glsl"
+#include "animation.glsl"
+
+const uint Looped   = 1u;
+const uint Reversed = 2u;
+const uint Expires  = 4u;
+
+struct Effect
+{
+    vec4  basis;  // x axis in xy, y axis in zw
+    vec2  origin;
+    float start;  // Seconds, on the clock of Time
+    float rate;   // Playback speed, 1 is the speed of the clip
+    uint  clip;
+    uint  flags;
+    uint  tint;   // RGBA8
+    uint  padding;
+};
+
+layout (std430, binding = 3) readonly buffer Effects
+{
+    Effect effects[];
+};
+
+out vec2 tex_coord;
+out vec4 tint;
+
+void main()
+{
+    Effect effect = effects[gl_BaseInstance + gl_InstanceID];
+    Clip   clip   = clips[effect.clip];
+
+//  Whole milliseconds, as the timers of AnimationSystem, so a frame switches at the same time on both sides
+    float elapsed  = floor((Time - effect.start) * 1000.0f * effect.rate + 0.5f);
+    bool  isLooped = (effect.flags & Looped) != 0u;
+
+//  A finished effect that expires collapses to a point and costs no fill
+    if(!isLooped && (effect.flags & Expires) != 0u && getStepAt(clip, elapsed) >= clip.duration)
+    {
+        gl_Position = vec4(0.0f);
+        tex_coord   = vec2(0.0f);
+        tint        = vec4(0.0f);
+
+        return;
+    }
+
+    SpriteFrame frame = frames[getFrameAt(clip, elapsed, isLooped, (effect.flags & Reversed) != 0u)];
+
+    vec2 local = getOutlinePoint(frame, gl_VertexID);
+    vec2 world = effect.origin + effect.basis.xy * local.x + effect.basis.zw * local.y;
+
+    gl_Position = ViewProjection * vec4(world.x, world.y, 0.0f, 1.0f);
+
+    tex_coord = mix(frame.texCoords.xy, frame.texCoords.zw, local / frame.size);
+    tint      = unpackUnorm4x8(effect.tint);
+}
@@ -0,0 +1,9 @@
+// Per-view data, written once per frame into a uniform buffer shared by every program.
+// Mirrors FrameUniforms in graphics/UniformBuffer.hpp, std140 layout.
+
+layout (std140, binding = 0) uniform FrameData
+{
+    mat4  ViewProjection;
+    vec2  ViewportSize;
+    float Time; // Seconds
+};
@@ -0,0 +1,23 @@
+// Frame table of SpriteManager, one entry per frame of every animation.
+// Mirrors SpriteManager::FrameData, std430 layout.
+
+struct SpriteFrame
+{
+    vec4 texCoords;  // left, top, right, bottom
+    vec2 size;       // In pixels
+    vec2 padding;
+    uint outline[8]; // x | y << 16, in pixels
+};
+
+layout (std430, binding = 1) readonly buffer SpriteFrames
+{
+    SpriteFrame frames[];
+};
+
+// Corner of the frame's mesh in pixels, drawn as an 8-vertex triangle fan
+vec2 getOutlinePoint(SpriteFrame frame, int corner)
+{
+    uint point = frame.outline[corner];
+
+    return vec2(point & 0xFFFFu, point >> 16);
+}
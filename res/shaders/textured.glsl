@@ -0,0 +1,21 @@
+// Shared fragment stage of the textured 2D quads.
+// VERTEX_TINT multiplies the texel by the colour of the vertex.
+
+out vec4 FragColor;
+
+in vec2 tex_coord;
+
+#ifdef VERTEX_TINT
+in vec4 tint;
+#endif
+
+uniform sampler2D texture0;
+
+void main()
+{
+    FragColor = texture(texture0, tex_coord);
+
+#ifdef VERTEX_TINT
+    FragColor *= tint;
+#endif
+}
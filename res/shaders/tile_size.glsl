@@ -0,0 +1,7 @@
+// Tile size in pixels of the map being drawn, packed into the base instance by TiledMap::packTileSize.
+// Vertex stage only.
+
+vec2 getTileSize()
+{
+    return vec2(gl_BaseInstance & 0xFFFF, (gl_BaseInstance >> 16) & 0xFFFF);
+}
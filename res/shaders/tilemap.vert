@@ -1,15 +1,20 @@
 #version 460 core
 
+// Tile vertices are 16-bit tile coordinates: the tile size of the draw turns them into pixels.
+
+#include "frame.glsl"
+#include "tile_size.glsl"
+
 layout (location = 0) in vec2 position;
 layout (location = 1) in vec2 texCoords;
 
-uniform mat4 ViewProjection = mat4(1.0f);
-
 out vec2 tex_coord;
 
 void main()
 {
-    gl_Position = ViewProjection * vec4(position.x, position.y, 0.0f, 1.0f);
+    const vec2 tileSize = getTileSize();
+
+    gl_Position = ViewProjection * vec4(position.x * tileSize.x, position.y * tileSize.y, 0.0f, 1.0f);
 
     tex_coord = texCoords;
-}
\ No newline at end of file
+}
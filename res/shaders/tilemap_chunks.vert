@@ -0,0 +1,20 @@
+#version 460 core
+
+// Streamed chunks: the vertices are 16-bit tile coordinates relative to the chunk, whose origin in tiles
+// is a constant attribute of its buffer. The tile size of the draw turns tiles into pixels.
+
+#include "frame.glsl"
+#include "tile_size.glsl"
+
+layout (location = 0) in vec2  position;
+layout (location = 1) in vec2  texCoords;
+layout (location = 2) in ivec2 chunk;
+
+out vec2 tex_coord;
+
+void main()
+{
+    gl_Position = ViewProjection * vec4((vec2(chunk) + position) * getTileSize(), 0.0f, 1.0f);
+
+    tex_coord = texCoords;
+}
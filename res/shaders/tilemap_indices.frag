@@ -0,0 +1,32 @@
+#version 460 core
+
+// Resolves the texel from the tile under the fragment: index 0 is an empty cell, otherwise index - 1
+// is the tile in the tileset, row by row. The tileset is taken to have no margin nor spacing, as the
+// tile meshes do, so its column count follows from its width. The gradients of the continuous tile
+// coordinates are used, so the jumps between tiles of the atlas do not pick the smallest mip level.
+
+layout (binding = 1) uniform usampler2D TileIndices;
+
+uniform sampler2D texture0;
+
+in vec2 tile_coord;
+flat in vec2 tile_size;
+
+out vec4 FragColor;
+
+void main()
+{
+    const uint index = texelFetch(TileIndices, min(ivec2(tile_coord), textureSize(TileIndices, 0) - 1), 0).r;
+
+    if (index == 0u)
+        discard;
+
+    const ivec2 tilesetSize = textureSize(texture0, 0);
+    const uint  columns     = max(uint(tilesetSize.x) / uint(tile_size.x), 1u);
+
+    const uint tile   = index - 1u;
+    const vec2 scale  = tile_size / vec2(tilesetSize);
+    const vec2 origin = vec2(tile % columns, tile / columns);
+
+    FragColor = textureGrad(texture0, (origin + fract(tile_coord)) * scale, dFdx(tile_coord) * scale, dFdy(tile_coord) * scale);
+}
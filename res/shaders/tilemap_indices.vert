@@ -0,0 +1,22 @@
+#version 460 core
+
+// One quad over the whole layer, its corners from gl_VertexID (drawn as a 4-vertex strip, no attributes).
+// The layer size comes from its tile index texture, the tile size from the draw.
+
+#include "frame.glsl"
+#include "tile_size.glsl"
+
+layout (binding = 1) uniform usampler2D TileIndices;
+
+out vec2 tile_coord;
+flat out vec2 tile_size;
+
+void main()
+{
+    const vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+
+    tile_coord = corner * vec2(textureSize(TileIndices, 0));
+    tile_size  = getTileSize();
+
+    gl_Position = ViewProjection * vec4(tile_coord * tile_size, 0.0f, 1.0f);
+}
@@ -0,0 +1,70 @@
+#ifndef AFFINE2D_HPP
+#define AFFINE2D_HPP
+
+#include <glm/glm.hpp>
+
+// The 2D affine part of a transform, 24 bytes instead of the 64 of a glm::mat4:
+// a point p maps to axisX * p.x + axisY * p.y + translation
+struct Affine2D
+{
+	Affine2D() noexcept;
+	Affine2D(const glm::vec2& theAxisX, const glm::vec2& theAxisY, const glm::vec2& theTranslation) noexcept;
+
+	static Affine2D fromMatrix(const glm::mat4& matrix) noexcept;
+	glm::mat4       toMatrix() const noexcept;
+
+	glm::vec2 transformPoint(const glm::vec2& point) const noexcept;
+
+//	Applies other first, then this
+	Affine2D combine(const Affine2D& other) const noexcept;
+
+	glm::vec2 axisX;
+	glm::vec2 axisY;
+	glm::vec2 translation;
+};
+
+static_assert(sizeof(Affine2D) == 24, "Affine2D must stay 24 bytes");
+
+inline Affine2D::Affine2D() noexcept:
+	axisX(1.0f, 0.0f),
+	axisY(0.0f, 1.0f),
+	translation(0.0f, 0.0f)
+{
+}
+
+inline Affine2D::Affine2D(const glm::vec2& theAxisX, const glm::vec2& theAxisY, const glm::vec2& theTranslation) noexcept:
+	axisX(theAxisX),
+	axisY(theAxisY),
+	translation(theTranslation)
+{
+}
+
+inline Affine2D Affine2D::fromMatrix(const glm::mat4& matrix) noexcept
+{
+	return Affine2D(glm::vec2(matrix[0].x, matrix[0].y), glm::vec2(matrix[1].x, matrix[1].y), glm::vec2(matrix[3].x, matrix[3].y));
+}
+
+inline glm::mat4 Affine2D::toMatrix() const noexcept
+{
+	glm::mat4 matrix(1.0f);
+	matrix[0] = glm::vec4(axisX.x, axisX.y, 0.0f, 0.0f);
+	matrix[1] = glm::vec4(axisY.x, axisY.y, 0.0f, 0.0f);
+	matrix[3] = glm::vec4(translation.x, translation.y, 0.0f, 1.0f);
+
+	return matrix;
+}
+
+inline glm::vec2 Affine2D::transformPoint(const glm::vec2& point) const noexcept
+{
+	return glm::vec2(axisX.x * point.x + axisY.x * point.y + translation.x,
+	                 axisX.y * point.x + axisY.y * point.y + translation.y);
+}
+
+inline Affine2D Affine2D::combine(const Affine2D& other) const noexcept
+{
+	return Affine2D(glm::vec2(axisX.x * other.axisX.x + axisY.x * other.axisX.y, axisX.y * other.axisX.x + axisY.y * other.axisX.y),
+	                glm::vec2(axisX.x * other.axisY.x + axisY.x * other.axisY.y, axisX.y * other.axisY.x + axisY.y * other.axisY.y),
+	                transformPoint(other.translation));
+}
+
+#endif // !AFFINE2D_HPP
@@ -1,12 +1,36 @@
-#include "graphics/Sprite2D.hpp"
+#include <cmath>
+#include <algorithm>
+
 #include "graphics/Animation.hpp"
 
 bool operator == (const Animation& a, const Animation& b) noexcept
 {
-    return a.sprites == b.sprites;
+    return a.first == b.first && a.duration == b.duration;
 }
 
 bool operator != (const Animation& a, const Animation& b) noexcept
 {
     return !(a == b);
-}
\ No newline at end of file
+}
+
+std::uint32_t Animation::getStepAt(float elapsed) const noexcept
+{
+    if(elapsed <= 0.0f)
+        return 0U;
+
+//  Same float arithmetic as animation.glsl, so both sides switch frames at the same time
+    const float steps = std::floor(elapsed / static_cast<float>(std::max(delay, 1U)));
+
+    return steps < 4294967040.0f ? static_cast<std::uint32_t>(steps) : UINT32_MAX;
+}
+
+std::uint32_t Animation::getFrameAt(float elapsed, bool isLooped, bool isReversed) const noexcept
+{
+    if(duration == 0U)
+        return InvalidFrame;
+
+    const std::uint32_t step  = getStepAt(elapsed);
+    const std::uint32_t frame = isLooped ? step % duration : std::min(step, duration - 1U);
+
+    return first + (isReversed ? duration - 1U - frame : frame);
+}
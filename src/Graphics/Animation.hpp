@@ -1,11 +1,21 @@
 #ifndef ANIMATION_HPP
 #define ANIMATION_HPP
 
+#include <cstdint>
+
+// Frames [first, first + duration) of the SpriteManager frame arena
 struct Animation
 {
-	const struct Sprite2D* sprites = nullptr;
-	unsigned duration = 0U;
-	unsigned delay    = 0U; // in milliseconds
+	static constexpr std::uint32_t InvalidFrame = UINT32_MAX;
+
+	std::uint32_t first = 0U;
+	unsigned duration   = 0U;
+	unsigned delay      = 0U; // in milliseconds
+
+//	Closed form of the playback, mirrored by animation.glsl: after elapsed milliseconds the clip is at
+//	step floor(elapsed / delay), a delay of 0 counting as 1. A clip that does not loop holds its last frame
+	std::uint32_t getStepAt(float elapsed) const noexcept;
+	std::uint32_t getFrameAt(float elapsed, bool isLooped, bool isReversed) const noexcept; // Into the frame arena, or InvalidFrame
 };
 
 bool operator == (const Animation& a, const Animation& b) noexcept;
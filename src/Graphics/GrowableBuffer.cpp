@@ -0,0 +1,116 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "graphics/GrowableBuffer.hpp"
+
+GrowableBuffer::GrowableBuffer(unsigned target, unsigned usage) noexcept:
+    m_buffer(0u),
+    m_target(target),
+    m_usage(usage),
+    m_size(0u),
+    m_capacity(0u)
+{
+}
+
+GrowableBuffer::~GrowableBuffer()
+{
+    clear();
+}
+
+std::size_t GrowableBuffer::append(const void* data, std::size_t size) noexcept
+{
+    if(size == 0U)
+        return m_size;
+
+    if(m_size + size > m_capacity && !reserve(std::max(m_size + size, m_capacity * 2U)))
+        return SIZE_MAX;
+
+    const std::size_t offset = m_size;
+
+    glBindBuffer(m_target, m_buffer);
+    glBufferSubData(m_target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+    glBindBuffer(m_target, 0);
+
+    m_size += size;
+    m_statistics.uploadedBytes += size;
+
+    return offset;
+}
+
+bool GrowableBuffer::reserve(std::size_t capacity) noexcept
+{
+    if(capacity <= m_capacity)
+        return true;
+
+    unsigned buffer = 0u;
+    glGenBuffers(1, &buffer);
+
+    if(!buffer)
+        return false;
+
+    glBindBuffer(m_target, buffer);
+    glBufferData(m_target, static_cast<GLsizeiptr>(capacity), nullptr, m_usage);
+    glBindBuffer(m_target, 0);
+
+    if(m_buffer)
+    {
+//      The copy targets leave the bindings of the caller alone
+        if(m_size)
+        {
+            glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(m_size));
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+            m_statistics.copiedBytes += m_size;
+        }
+
+        glDeleteBuffers(1, &m_buffer);
+        ++m_statistics.reallocations;
+    }
+
+    m_buffer   = buffer;
+    m_capacity = capacity;
+
+    return true;
+}
+
+void GrowableBuffer::clear() noexcept
+{
+    if(m_buffer)
+    {
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0u;
+    }
+
+    m_size     = 0u;
+    m_capacity = 0u;
+}
+
+void GrowableBuffer::rewind() noexcept
+{
+    m_size = 0u;
+}
+
+unsigned GrowableBuffer::getNativeHandle() const noexcept
+{
+    return m_buffer;
+}
+
+std::size_t GrowableBuffer::getSize() const noexcept
+{
+    return m_size;
+}
+
+std::size_t GrowableBuffer::getCapacity() const noexcept
+{
+    return m_capacity;
+}
+
+const GrowableBuffer::Statistics& GrowableBuffer::getStatistics() const noexcept
+{
+    return m_statistics;
+}
@@ -0,0 +1,48 @@
+#ifndef GROWABLE_BUFFER_HPP
+#define GROWABLE_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "system/NonCopyable.hpp"
+
+// Append-only GPU buffer. Only the appended bytes are uploaded, with glBufferSubData; when the storage
+// is full it doubles, and the old content is copied on the GPU with glCopyBufferSubData.
+// Offsets of data already appended never change, but the GL name does on growth: vertex arrays and
+// indexed bindings that refer to the buffer have to be set up again when getNativeHandle() changes.
+class GrowableBuffer:
+    private NonCopyable
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t uploadedBytes = 0U;
+        std::uint64_t copiedBytes   = 0U; // Moved on the GPU by reallocations
+        std::uint32_t reallocations = 0U;
+    };
+
+public:
+    explicit GrowableBuffer(unsigned target, unsigned usage) noexcept; // GL_ARRAY_BUFFER, GL_SHADER_STORAGE_BUFFER...
+    ~GrowableBuffer();
+
+//  Returns the byte offset of the data, or SIZE_MAX if the buffer could not be allocated
+    std::size_t append(const void* data, std::size_t size) noexcept;
+    bool        reserve(std::size_t capacity) noexcept;
+    void        clear() noexcept; // Releases the storage
+    void        rewind() noexcept; // Keeps the storage, the next append writes from offset 0 again
+
+    unsigned          getNativeHandle() const noexcept;
+    std::size_t       getSize()         const noexcept;
+    std::size_t       getCapacity()     const noexcept;
+    const Statistics& getStatistics()   const noexcept;
+
+private:
+    unsigned    m_buffer;
+    unsigned    m_target;
+    unsigned    m_usage;
+    std::size_t m_size;
+    std::size_t m_capacity;
+    Statistics  m_statistics;
+};
+
+#endif // !GROWABLE_BUFFER_HPP
@@ -73,6 +73,30 @@ bool Image::loadFromFile(const std::string& filepath) noexcept
     return true;
 }
 
+bool Image::loadFromMemory(const void* data, std::size_t size) noexcept
+{
+    m_pixels.clear();
+
+    if (!data || !size)
+        return false;
+
+    int width = 0;
+    int height = 0;
+    int bytePerPixel = 0;
+    unsigned char* pixels = stbi_load_from_memory(static_cast<const stbi_uc*>(data), static_cast<int>(size), &width, &height, &bytePerPixel, STBI_rgb_alpha);
+
+    if (!pixels)
+        return false;
+
+    m_size = { static_cast<unsigned>(width), static_cast<unsigned>(height) };
+
+    m_pixels.resize(static_cast<size_t>(width * height * 4));
+    std::memcpy(&m_pixels[0], pixels, m_pixels.size());
+    stbi_image_free(pixels);
+
+    return true;
+}
+
 bool Image::saveToFile(const std::string& filename) const noexcept
 {
     if (!m_pixels.empty() && (m_size.x > 0) && (m_size.y > 0))
@@ -16,6 +16,7 @@ public:
 
     bool create(unsigned width, unsigned height, const Color& color) noexcept;
     bool loadFromFile(const std::string& filepath) noexcept;
+    bool loadFromMemory(const void* data, std::size_t size) noexcept;
     bool saveToFile(const std::string& filepath) const noexcept;
 
     const unsigned char* getPixels() const noexcept;
@@ -0,0 +1,43 @@
+#ifndef PACKED_VERTEX2D_HPP
+#define PACKED_VERTEX2D_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+// Half the size of Vertex2D: unsigned 16-bit positions, read as integers converted to float,
+// and texture coordinates normalized to 16 bits (1 / 65535 precision).
+// Positions are relative to the origin of their mesh, in the units its shader expects
+struct PackedVertex2D
+{
+	PackedVertex2D() noexcept;
+	PackedVertex2D(std::uint16_t x, std::uint16_t y, float u, float v) noexcept;
+
+	static std::uint16_t packUnorm(float value) noexcept;
+
+	glm::u16vec2 position;
+	glm::u16vec2 texCoords;
+};
+
+static_assert(sizeof(PackedVertex2D) == 8, "PackedVertex2D must stay 8 bytes");
+
+inline PackedVertex2D::PackedVertex2D() noexcept:
+	position(0, 0),
+	texCoords(0, 0)
+{
+}
+
+inline PackedVertex2D::PackedVertex2D(std::uint16_t x, std::uint16_t y, float u, float v) noexcept:
+	position(x, y),
+	texCoords(packUnorm(u), packUnorm(v))
+{
+}
+
+inline std::uint16_t PackedVertex2D::packUnorm(float value) noexcept
+{
+	return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+#endif // !PACKED_VERTEX2D_HPP
@@ -0,0 +1,84 @@
+#include <glad/glad.h>
+
+#include <vector>
+#include <cstdint>
+
+#include "graphics/PolygonIndexBuffer.hpp"
+
+PolygonIndexBuffer::PolygonIndexBuffer() noexcept:
+    m_buffer(0u),
+    m_corners(0u)
+{
+}
+
+PolygonIndexBuffer::~PolygonIndexBuffer()
+{
+    if(m_buffer)
+        glDeleteBuffers(1, &m_buffer);
+}
+
+bool PolygonIndexBuffer::create(unsigned corners) noexcept
+{
+    if(m_buffer)
+        return corners == m_corners;
+
+    if(corners < 3U || corners > 65536U)
+        return false;
+
+    m_corners = corners;
+
+    const std::size_t polygons  = getMaxPolygons();
+    const unsigned    triangles = corners - 2U;
+
+    std::vector<std::uint16_t> indices(polygons * triangles * 3U);
+
+    for(std::size_t i = 0; i < polygons; ++i)
+    {
+        auto vertex  = static_cast<std::uint16_t>(i * corners);
+        auto polygon = &indices[i * triangles * 3U];
+
+        for(unsigned j = 0; j < triangles; ++j)
+        {
+            polygon[j * 3U]      = vertex;
+            polygon[j * 3U + 1U] = static_cast<std::uint16_t>(vertex + j + 1U);
+            polygon[j * 3U + 2U] = static_cast<std::uint16_t>(vertex + j + 2U);
+        }
+    }
+
+    glGenBuffers(1, &m_buffer);
+
+    if(!m_buffer)
+        return false;
+
+//  Bound through the copy target, so the element binding of the current vertex array is left alone
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(std::uint16_t)), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    return true;
+}
+
+void PolygonIndexBuffer::bind() const noexcept
+{
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_buffer);
+}
+
+unsigned PolygonIndexBuffer::getNativeHandle() const noexcept
+{
+    return m_buffer;
+}
+
+unsigned PolygonIndexBuffer::getCorners() const noexcept
+{
+    return m_corners;
+}
+
+unsigned PolygonIndexBuffer::getIndicesPerPolygon() const noexcept
+{
+    return (m_corners - 2U) * 3U;
+}
+
+std::size_t PolygonIndexBuffer::getMaxPolygons() const noexcept
+{
+    return m_corners ? 65536U / m_corners : 0U;
+}
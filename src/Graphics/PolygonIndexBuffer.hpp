@@ -0,0 +1,36 @@
+#ifndef POLYGON_INDEX_BUFFER_HPP
+#define POLYGON_INDEX_BUFFER_HPP
+
+#include <cstddef>
+
+#include "system/NonCopyable.hpp"
+
+// 16-bit indices of convex polygons with a fixed number of corners, each one a triangle fan
+// (0 1 2, 0 2 3, ...). Every mesh of such polygons shares them: a draw starts at index 0 and
+// selects its polygons with the base vertex, getMaxPolygons() at a time. Quads by default
+class PolygonIndexBuffer:
+    private NonCopyable
+{
+public:
+    static constexpr std::size_t MaxQuads = 16384U; // 4 * MaxQuads vertices fit 16 bits
+
+public:
+    PolygonIndexBuffer() noexcept;
+    ~PolygonIndexBuffer();
+
+    bool create(unsigned corners = 4U) noexcept;
+
+//  Attaches the indices to the vertex array bound at the time of the call
+    void bind() const noexcept;
+
+    unsigned    getNativeHandle()      const noexcept;
+    unsigned    getCorners()           const noexcept;
+    unsigned    getIndicesPerPolygon() const noexcept; // (corners - 2) * 3
+    std::size_t getMaxPolygons()       const noexcept;
+
+private:
+    unsigned m_buffer;
+    unsigned m_corners;
+};
+
+#endif // !POLYGON_INDEX_BUFFER_HPP
@@ -0,0 +1,178 @@
+#include <glad/glad.h>
+
+#include <numeric>
+
+#include "graphics/Shader.hpp"
+#include "graphics/RenderQueue.hpp"
+
+RenderQueue::RenderQueue() noexcept
+{
+}
+
+std::uint64_t RenderQueue::makeKey(std::uint8_t layer, std::uint16_t depth, unsigned program, unsigned texture, unsigned vao) noexcept
+{
+    return (static_cast<std::uint64_t>(layer)              << 56) |
+           (static_cast<std::uint64_t>(depth)              << 40) |
+           (static_cast<std::uint64_t>(program & 0xFFFU)   << 28) |
+           (static_cast<std::uint64_t>(texture & 0xFFFFU)  << 12) |
+           (static_cast<std::uint64_t>(vao     & 0xFFFU));
+}
+
+void RenderQueue::submit(DrawPacket packet, std::uint8_t layer, std::uint16_t depth) noexcept
+{
+    packet.key = makeKey(layer, depth, packet.shader ? packet.shader->getNativeHandle() : 0U, packet.texture, packet.vao);
+    m_packets.push_back(packet);
+}
+
+void RenderQueue::submit(const DrawPacket& packet) noexcept
+{
+    m_packets.push_back(packet);
+}
+
+void RenderQueue::execute() noexcept
+{
+    m_statistics = Statistics();
+
+    if(m_packets.empty())
+        return;
+
+    sort();
+
+    m_statistics.packets         = static_cast<std::uint32_t>(m_packets.size());
+    m_statistics.stateChanges    = countStateChanges(m_packets, m_order.data());
+    m_statistics.unsortedChanges = countStateChanges(m_packets, nullptr);
+    m_statistics.savedChanges    = (m_statistics.unsortedChanges > m_statistics.stateChanges) ? m_statistics.unsortedChanges - m_statistics.stateChanges : 0U;
+
+    const Shader* shader = nullptr;
+    unsigned texture     = 0U;
+    unsigned texture1    = 0U;
+    unsigned vao         = 0U;
+    bool     isFirst     = true;
+
+    for(auto index : m_order)
+    {
+        const auto& packet = m_packets[index];
+
+        if(isFirst || packet.shader != shader)
+            Shader::bind(shader = packet.shader);
+
+        if(isFirst || packet.texture != texture)
+            glBindTexture(GL_TEXTURE_2D, texture = packet.texture);
+
+//      Unit 0 stays the active one
+        if(packet.texture1 != texture1)
+        {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, texture1 = packet.texture1);
+            glActiveTexture(GL_TEXTURE0);
+        }
+
+        if(isFirst || packet.vao != vao)
+            glBindVertexArray(vao = packet.vao);
+
+        isFirst = false;
+
+        if(packet.indexType)
+            glDrawElementsInstancedBaseVertexBaseInstance(packet.mode, static_cast<GLsizei>(packet.count), packet.indexType, reinterpret_cast<const void*>(packet.first),
+                                                          static_cast<GLsizei>(packet.instanceCount), packet.baseVertex, packet.baseInstance);
+        else
+            glDrawArraysInstancedBaseInstance(packet.mode, static_cast<GLint>(packet.first), static_cast<GLsizei>(packet.count),
+                                              static_cast<GLsizei>(packet.instanceCount), packet.baseInstance);
+    }
+
+    if(texture1)
+    {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    Shader::bind(nullptr);
+
+    clear();
+}
+
+void RenderQueue::clear() noexcept
+{
+    m_packets.clear();
+}
+
+std::size_t RenderQueue::getSize() const noexcept
+{
+    return m_packets.size();
+}
+
+const RenderQueue::Statistics& RenderQueue::getStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+void RenderQueue::sort() noexcept
+{
+    const std::size_t size = m_packets.size();
+
+    m_keys.resize(size);
+    m_keysScratch.resize(size);
+    m_order.resize(size);
+    m_orderScratch.resize(size);
+
+    for(std::size_t i = 0; i < size; ++i)
+        m_keys[i] = m_packets[i].key;
+
+    std::iota(m_order.begin(), m_order.end(), 0U);
+
+//  LSD radix sort, one byte per pass. Stable, so equal keys stay in submission order.
+//  A pass where every key has the same byte would only copy the arrays and is skipped
+    for(unsigned shift = 0; shift < 64; shift += 8)
+    {
+        std::uint32_t histogram[256]{};
+
+        for(auto key : m_keys)
+            ++histogram[(key >> shift) & 0xFFU];
+
+        if(histogram[(m_keys[0] >> shift) & 0xFFU] == size)
+            continue;
+
+        std::uint32_t offset = 0U;
+
+        for(auto& bucket : histogram)
+        {
+            auto count = bucket;
+            bucket     = offset;
+            offset    += count;
+        }
+
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            auto slot = histogram[(m_keys[i] >> shift) & 0xFFU]++;
+
+            m_keysScratch[slot]  = m_keys[i];
+            m_orderScratch[slot] = m_order[i];
+        }
+
+        m_keys.swap(m_keysScratch);
+        m_order.swap(m_orderScratch);
+    }
+}
+
+std::uint32_t RenderQueue::countStateChanges(const std::vector<DrawPacket>& packets, const std::uint32_t* order) noexcept
+{
+    std::uint32_t changes = 0U;
+    const DrawPacket* previous = nullptr;
+
+    for(std::size_t i = 0; i < packets.size(); ++i)
+    {
+        const auto& packet = packets[order ? order[i] : i];
+
+        if(!previous)
+            changes += 3U;
+        else
+            changes += (packet.shader != previous->shader) + (packet.texture != previous->texture) + (packet.texture1 != previous->texture1) + (packet.vao != previous->vao);
+
+        previous = &packet;
+    }
+
+    return changes;
+}
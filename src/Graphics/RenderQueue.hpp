@@ -0,0 +1,77 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "system/NonCopyable.hpp"
+
+// A draw, with every piece of state it needs. Indexed when indexType is set, otherwise an array draw
+struct DrawPacket
+{
+    std::uint64_t       key           = 0U; // RenderQueue::makeKey
+    const class Shader* shader        = nullptr;
+    unsigned            texture       = 0U;
+    unsigned            texture1      = 0U; // Second texture, on unit 1: lookup data such as tile indices
+    unsigned            vao           = 0U;
+    unsigned            mode          = 0U; // GL_TRIANGLES, GL_TRIANGLE_STRIP...
+    unsigned            count         = 0U; // Vertices or indices
+    unsigned            indexType     = 0U; // GL_UNSIGNED_SHORT, GL_UNSIGNED_INT or 0
+    std::uintptr_t      first         = 0U; // First vertex, or byte offset into the index buffer
+    int                 baseVertex    = 0;
+    unsigned            instanceCount = 1U;
+    unsigned            baseInstance  = 0U;
+};
+
+// Collects the draws of a frame, radix-sorts them by key and executes them, binding a program,
+// texture or vertex array only when it differs from the previous draw.
+// Equal keys keep their submission order.
+class RenderQueue:
+    private NonCopyable
+{
+public:
+    struct Statistics
+    {
+        std::uint32_t packets         = 0U;
+        std::uint32_t stateChanges    = 0U; // Program, texture and vertex array binds issued after sorting
+        std::uint32_t unsortedChanges = 0U; // Binds the submission order would have needed
+        std::uint32_t savedChanges    = 0U;
+    };
+
+public:
+    RenderQueue() noexcept;
+
+//  From the most to the least significant bits: layer (8), depth (16), program (12), texture (16), vertex array (12).
+//  The GL names are truncated: two names sharing the low bits only sort together, each packet still binds its own state
+    static std::uint64_t makeKey(std::uint8_t layer, std::uint16_t depth, unsigned program, unsigned texture, unsigned vao) noexcept;
+
+//  Fills the key from the state of the packet
+    void submit(DrawPacket packet, std::uint8_t layer, std::uint16_t depth) noexcept;
+
+//  Keeps the key of the packet
+    void submit(const DrawPacket& packet) noexcept;
+
+//  Sorts, draws and empties the queue. Leaves no program, texture or vertex array bound
+    void execute() noexcept;
+    void clear()   noexcept;
+
+    std::size_t getSize() const noexcept;
+    const Statistics& getStatistics() const noexcept; // Of the last execute()
+
+private:
+    void sort() noexcept;
+
+    static std::uint32_t countStateChanges(const std::vector<DrawPacket>& packets, const std::uint32_t* order) noexcept;
+
+private:
+    std::vector<DrawPacket>    m_packets;
+    std::vector<std::uint64_t> m_keys;
+    std::vector<std::uint64_t> m_keysScratch;
+    std::vector<std::uint32_t> m_order;
+    std::vector<std::uint32_t> m_orderScratch;
+
+    Statistics m_statistics;
+};
+
+#endif // !RENDER_QUEUE_HPP
@@ -0,0 +1,353 @@
+#include "system/ThreadPool.hpp"
+#include "graphics/SceneGraph.hpp"
+
+namespace
+{
+    const Affine2D Identity;
+}
+
+SceneGraph::SceneGraph() noexcept:
+    m_isSorted(true)
+{
+}
+
+SceneGraph::Node SceneGraph::create(Node parent) noexcept
+{
+    if(parent != Invalid && !isValid(parent))
+        return Invalid;
+
+    Node node;
+
+    if(!m_freeNodes.empty())
+    {
+        node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else
+    {
+        node = static_cast<Node>(m_links.size());
+        m_links.emplace_back();
+    }
+
+    Links& links  = m_links[node];
+    links         = Links();
+    links.local   = m_locals.create();
+    links.isAlive = true;
+    links.isDirty = true;
+
+    if(parent != Invalid)
+        link(node, parent);
+
+    m_isSorted = false;
+    ++m_statistics.nodes;
+
+    return node;
+}
+
+void SceneGraph::destroy(Node node) noexcept
+{
+    if(!isValid(node))
+        return;
+
+    unlink(node);
+
+    std::vector<Node> stack(1U, node);
+
+    while(!stack.empty())
+    {
+        const Node current = stack.back();
+        stack.pop_back();
+
+        for(Node child = m_links[current].firstChild; child != Invalid; child = m_links[child].nextSibling)
+            stack.push_back(child);
+
+        m_locals.destroy(m_links[current].local);
+        m_links[current] = Links();
+        m_freeNodes.push_back(current);
+
+        --m_statistics.nodes;
+    }
+
+    m_isSorted = false;
+}
+
+bool SceneGraph::setParent(Node node, Node parent) noexcept
+{
+    if(!isValid(node) || (parent != Invalid && !isValid(parent)))
+        return false;
+
+//  A node cannot hang under its own subtree
+    for(Node ancestor = parent; ancestor != Invalid; ancestor = m_links[ancestor].parent)
+        if(ancestor == node)
+            return false;
+
+    unlink(node);
+
+    if(parent != Invalid)
+        link(node, parent);
+
+    invalidate(node);
+    m_isSorted = false;
+
+    return true;
+}
+
+SceneGraph::Node SceneGraph::getParent(Node node) const noexcept
+{
+    return isValid(node) ? m_links[node].parent : Invalid;
+}
+
+void SceneGraph::setPosition(Node node, float x, float y) noexcept
+{
+    if(isValid(node))
+    {
+        m_locals.setPosition(m_links[node].local, x, y);
+        invalidate(node);
+    }
+}
+
+void SceneGraph::setRotation(Node node, float angle) noexcept
+{
+    if(isValid(node))
+    {
+        m_locals.setRotation(m_links[node].local, angle);
+        invalidate(node);
+    }
+}
+
+void SceneGraph::setScale(Node node, float factorX, float factorY) noexcept
+{
+    if(isValid(node))
+    {
+        m_locals.setScale(m_links[node].local, factorX, factorY);
+        invalidate(node);
+    }
+}
+
+void SceneGraph::setOrigin(Node node, float x, float y) noexcept
+{
+    if(isValid(node))
+    {
+        m_locals.setOrigin(m_links[node].local, x, y);
+        invalidate(node);
+    }
+}
+
+void SceneGraph::move(Node node, float offsetX, float offsetY) noexcept
+{
+    const glm::vec2 position = getPosition(node);
+
+    setPosition(node, position.x + offsetX, position.y + offsetY);
+}
+
+void SceneGraph::rotate(Node node, float angle) noexcept
+{
+    setRotation(node, getRotation(node) + angle);
+}
+
+glm::vec2 SceneGraph::getPosition(Node node) const noexcept
+{
+    return isValid(node) ? m_locals.getPosition(m_links[node].local) : glm::vec2(0.0f, 0.0f);
+}
+
+float SceneGraph::getRotation(Node node) const noexcept
+{
+    return isValid(node) ? m_locals.getRotation(m_links[node].local) : 0.0f;
+}
+
+glm::vec2 SceneGraph::getScale(Node node) const noexcept
+{
+    return isValid(node) ? m_locals.getScale(m_links[node].local) : glm::vec2(1.0f, 1.0f);
+}
+
+glm::vec2 SceneGraph::getOrigin(Node node) const noexcept
+{
+    return isValid(node) ? m_locals.getOrigin(m_links[node].local) : glm::vec2(0.0f, 0.0f);
+}
+
+void SceneGraph::update() noexcept
+{
+    if(!m_isSorted)
+        sort();
+
+    m_locals.update();
+    m_statistics.updated = updateEntries(0U, m_nodes.size());
+}
+
+void SceneGraph::update(ThreadPool& pool) noexcept
+{
+    if(!m_isSorted)
+        sort();
+
+    m_locals.update(pool);
+    m_statistics.updated = 0U;
+
+    for(std::size_t level = 0; level + 1U < m_levels.size(); ++level)
+    {
+        const std::size_t begin = m_levels[level];
+        const std::size_t end   = m_levels[level + 1U];
+
+        if(end - begin < MinParallelLevel)
+        {
+            m_statistics.updated += updateEntries(begin, end);
+
+            continue;
+        }
+
+//      The level only reads the one above, already complete
+        std::vector<std::uint32_t> updated(pool.getChunkCount(end - begin), 0U);
+
+        pool.parallelFor(end - begin, [&](std::size_t chunk, std::size_t first, std::size_t last)
+        {
+            updated[chunk] = updateEntries(begin + first, begin + last);
+        });
+
+        for(const auto count : updated)
+            m_statistics.updated += count;
+    }
+}
+
+const Affine2D& SceneGraph::getWorldAffine(Node node) const noexcept
+{
+    if(!isValid(node) || m_links[node].entry == Invalid)
+        return Identity;
+
+    return m_worlds[m_links[node].entry];
+}
+
+const std::vector<Affine2D>& SceneGraph::getWorldAffines() const noexcept
+{
+    return m_worlds;
+}
+
+SceneGraph::Node SceneGraph::getNodeAt(std::size_t entry) const noexcept
+{
+    return (entry < m_nodes.size()) ? m_nodes[entry] : Invalid;
+}
+
+std::size_t SceneGraph::getNodeCount() const noexcept
+{
+    return m_statistics.nodes;
+}
+
+const SceneGraph::Statistics& SceneGraph::getStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+void SceneGraph::link(Node node, Node parent) noexcept
+{
+    Links& links = m_links[node];
+
+    links.parent      = parent;
+    links.prevSibling = Invalid;
+    links.nextSibling = m_links[parent].firstChild;
+
+    if(links.nextSibling != Invalid)
+        m_links[links.nextSibling].prevSibling = node;
+
+    m_links[parent].firstChild = node;
+}
+
+void SceneGraph::unlink(Node node) noexcept
+{
+    Links& links = m_links[node];
+
+    if(links.parent == Invalid)
+        return;
+
+    if(links.prevSibling != Invalid)
+        m_links[links.prevSibling].nextSibling = links.nextSibling;
+    else
+        m_links[links.parent].firstChild = links.nextSibling;
+
+    if(links.nextSibling != Invalid)
+        m_links[links.nextSibling].prevSibling = links.prevSibling;
+
+    links.parent      = Invalid;
+    links.prevSibling = Invalid;
+    links.nextSibling = Invalid;
+}
+
+void SceneGraph::invalidate(Node node) noexcept
+{
+    m_links[node].isDirty = true;
+}
+
+void SceneGraph::sort() noexcept
+{
+    m_nodes.clear();
+    m_levels.clear();
+
+//  Breadth first from the roots: the nodes come out level by level, the children of a node side by side
+    for(Node node = 0; node < m_links.size(); ++node)
+        if(m_links[node].isAlive && m_links[node].parent == Invalid)
+            m_nodes.push_back(node);
+
+    for(std::size_t begin = 0; begin < m_nodes.size(); )
+    {
+        const std::size_t end = m_nodes.size();
+
+        m_levels.push_back(static_cast<std::uint32_t>(begin));
+
+        for(std::size_t i = begin; i < end; ++i)
+            for(Node child = m_links[m_nodes[i]].firstChild; child != Invalid; child = m_links[child].nextSibling)
+                m_nodes.push_back(child);
+
+        begin = end;
+    }
+
+    m_levels.push_back(static_cast<std::uint32_t>(m_nodes.size()));
+
+    m_parents.resize(m_nodes.size());
+    m_dirty.resize(m_nodes.size());
+    m_worlds.resize(m_nodes.size());
+
+//  Entries moved, so every world affine is recomputed once
+    for(std::size_t entry = 0; entry < m_nodes.size(); ++entry)
+    {
+        Links& links  = m_links[m_nodes[entry]];
+        links.entry   = static_cast<std::uint32_t>(entry);
+        links.isDirty = true;
+    }
+
+    for(std::size_t entry = 0; entry < m_nodes.size(); ++entry)
+    {
+        const Node parent = m_links[m_nodes[entry]].parent;
+        m_parents[entry]  = (parent != Invalid) ? m_links[parent].entry : Invalid;
+    }
+
+    m_isSorted           = true;
+    m_statistics.levels  = static_cast<std::uint32_t>(m_levels.size() - 1U);
+    ++m_statistics.sorts;
+}
+
+std::uint32_t SceneGraph::updateEntries(std::size_t begin, std::size_t end) noexcept
+{
+    std::uint32_t updated = 0U;
+
+    for(std::size_t entry = begin; entry < end; ++entry)
+    {
+        Links&              links  = m_links[m_nodes[entry]];
+        const std::uint32_t parent = m_parents[entry];
+        const bool          dirty  = links.isDirty || (parent != Invalid && m_dirty[parent]);
+
+        m_dirty[entry] = dirty;
+
+        if(!dirty)
+            continue;
+
+        const Affine2D& local = m_locals.getAffine(links.local);
+
+        m_worlds[entry] = (parent != Invalid) ? m_worlds[parent].combine(local) : local;
+        links.isDirty   = false;
+        ++updated;
+    }
+
+    return updated;
+}
+
+bool SceneGraph::isValid(Node node) const noexcept
+{
+    return node < m_links.size() && m_links[node].isAlive;
+}
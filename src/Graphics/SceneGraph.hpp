@@ -0,0 +1,113 @@
+#ifndef SCENE_GRAPH_HPP
+#define SCENE_GRAPH_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "system/NonCopyable.hpp"
+#include "graphics/Affine2D.hpp"
+#include "graphics/TransformSystem.hpp"
+
+// Parent/child transforms. The local transforms live in a TransformSystem; the world affines are kept in
+// flattened arrays sorted by depth, so every parent comes before its children and update() is one linear
+// pass: a node is recomputed when its local transform or one of its ancestors changed. The nodes of one
+// depth only read the level above, so wide levels are split across the threads of a pool.
+// Structural changes (create, destroy, setParent) re-sort the arrays at the next update
+class SceneGraph:
+    private NonCopyable
+{
+public:
+    using Node = std::uint32_t;
+
+    static constexpr std::uint32_t Invalid = UINT32_MAX;
+
+    struct Statistics
+    {
+        std::uint32_t nodes   = 0U;
+        std::uint32_t levels  = 0U;
+        std::uint32_t updated = 0U; // World affines recomputed by the last update
+        std::uint32_t sorts   = 0U;
+    };
+
+public:
+    SceneGraph() noexcept;
+
+    Node create(Node parent = Invalid) noexcept;
+    void destroy(Node node) noexcept; // With its whole subtree
+
+//  false if the parent is the node itself or one of its descendants. The local transform is kept,
+//  so the node moves with its new parent
+    bool setParent(Node node, Node parent) noexcept;
+    Node getParent(Node node) const noexcept;
+
+//  The local transform, relative to the parent, with the conventions of Transform2D
+    void setPosition(Node node, float x, float y) noexcept;
+    void setRotation(Node node, float angle) noexcept;
+    void setScale(Node node, float factorX, float factorY) noexcept;
+    void setOrigin(Node node, float x, float y) noexcept;
+
+    void move(Node node, float offsetX, float offsetY) noexcept;
+    void rotate(Node node, float angle) noexcept;
+
+    glm::vec2 getPosition(Node node) const noexcept;
+    float     getRotation(Node node) const noexcept;
+    glm::vec2 getScale(Node node)    const noexcept;
+    glm::vec2 getOrigin(Node node)   const noexcept;
+
+    void update() noexcept;
+    void update(class ThreadPool& pool) noexcept;
+
+//  As of the last update, drawable as is by SpriteBatch and SpriteInstancer
+    const Affine2D& getWorldAffine(Node node) const noexcept;
+
+//  Every world affine, parents first; getNodeAt gives the node of an entry
+    const std::vector<Affine2D>& getWorldAffines() const noexcept;
+    Node                         getNodeAt(std::size_t entry) const noexcept;
+
+    std::size_t       getNodeCount()  const noexcept;
+    const Statistics& getStatistics() const noexcept;
+
+private:
+    static constexpr std::size_t MinParallelLevel = 4096U; // Narrower levels are not worth waking the pool
+
+//  Per node, indexed by the handle. Children are an intrusive list
+    struct Links
+    {
+        Node                       parent      = Invalid;
+        Node                       firstChild  = Invalid;
+        Node                       nextSibling = Invalid;
+        Node                       prevSibling = Invalid;
+        TransformSystem::Transform local       = TransformSystem::Invalid;
+        std::uint32_t              entry       = Invalid; // In the flattened arrays
+        bool                       isAlive     = false;
+        bool                       isDirty     = false;  // Local transform changed since the last update
+    };
+
+    void          link(Node node, Node parent) noexcept;
+    void          unlink(Node node) noexcept;
+    void          invalidate(Node node) noexcept;
+    void          sort() noexcept;
+    std::uint32_t updateEntries(std::size_t begin, std::size_t end) noexcept;
+
+    bool isValid(Node node) const noexcept;
+
+private:
+    TransformSystem    m_locals;
+    std::vector<Links> m_links;
+    std::vector<Node>  m_freeNodes;
+
+//  Flattened, sorted by depth
+    std::vector<Node>          m_nodes;
+    std::vector<std::uint32_t> m_parents;   // Entry of the parent, Invalid for a root
+    std::vector<std::uint8_t>  m_dirty;     // Recomputed by the pass, read by the children
+    std::vector<Affine2D>      m_worlds;
+    std::vector<std::uint32_t> m_levels;    // First entry of each depth, and the end
+    bool                       m_isSorted;
+
+    Statistics m_statistics;
+};
+
+#endif // !SCENE_GRAPH_HPP
@@ -1,39 +1,61 @@
 #include <glad/glad.h>
 
 #include <iostream>
-#include <cstdio>
+#include <chrono>
+#include <cstring>
 
-#include "system/FileProvider.hpp"
+#include <glm/gtc/type_ptr.hpp>
+
+#include "system/StringId.hpp"
+#include "graphics/ShaderCache.hpp"
+#include "graphics/ShaderPreprocessor.hpp"
 #include "graphics/Shader.hpp"
 
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace
+{
+    std::uint64_t now() noexcept
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    Shader::UniformStatistics uniformStatistics; // Every program, GL thread only
+}
+
 Shader::Shader() noexcept: 
-    m_program(0u)
+    m_program(0u),
+    m_stages(),
+    m_stageCount(0u),
+    m_cacheKey(0u),
+    m_buildTime(0u),
+    m_isPending(false),
+    m_isLinked(false)
 {
     m_program = glCreateProgram();
 }
 
 Shader::~Shader()
 {
+    releaseStages();
+
     if(m_program)
         glDeleteProgram(m_program);
 }
 
 bool Shader::compile(const std::string& filename, unsigned type) noexcept
 {
-    if(!m_program)
+    if(!m_program || m_isPending)
         return false;
 
-    const std::string filepath = FileProvider().getPathToFile(filename);
-
-    if(filepath.empty())
-        return false;
-
-    std::string source = readShaderSourceFromFile(filepath);
+    std::string source;
 
-    if(source.empty())
+    if(!ShaderPreprocessor::process(filename, {}, source))
         return false;
 
-    unsigned shader = compileShaderFromSource(source, type);
+    unsigned shader = compileShaderFromSource(source.data(), static_cast<int>(source.size()), type);
 
     if(!shader)
         return false;
@@ -43,20 +65,160 @@ bool Shader::compile(const std::string& filename, unsigned type) noexcept
 
 bool Shader::compile(const std::string &vert, const std::string &frag) noexcept
 {
-    return compile(vert, GL_VERTEX_SHADER) && compile(frag, GL_FRAGMENT_SHADER);
+    return compileAsync(vert, frag) && finish();
 }
 
 bool Shader::compile(const std::string &vert, const std::string &frag, const std::string &geom) noexcept
 {
-    return compile(vert, GL_VERTEX_SHADER) && compile(frag, GL_FRAGMENT_SHADER) && compile(geom, GL_GEOMETRY_SHADER);
+    return compileAsync(vert, frag, geom) && finish();
+}
+
+bool Shader::compileAsync(const std::string &vert, const std::string &frag) noexcept
+{
+    const std::string* filenames[] { &vert, &frag };
+    const unsigned     types[]     { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+
+    return startProgram(filenames, types, 2);
+}
+
+bool Shader::compileAsync(const std::string &vert, const std::string &frag, const std::string &geom) noexcept
+{
+    const std::string* filenames[] { &vert, &frag, &geom };
+    const unsigned     types[]     { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER };
+
+    return startProgram(filenames, types, 3);
+}
+
+bool Shader::compileFromSource(const std::string& vertSource, const std::string& fragSource) noexcept
+{
+    return compileFromSourceAsync(vertSource, fragSource) && finish();
+}
+
+bool Shader::compileFromSourceAsync(const std::string& vertSource, const std::string& fragSource) noexcept
+{
+    const std::string sources[] { vertSource, fragSource };
+    const unsigned    types[]   { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+
+    return startProgramFromSource(sources, types, 2);
+}
+
+bool Shader::isPending() const noexcept
+{
+    return m_isPending;
+}
+
+bool Shader::isReady() const noexcept
+{
+    if(!m_isPending || !isParallelCompileSupported())
+        return true;
+
+    int completed = 0;
+    glGetProgramiv(m_program, GL_COMPLETION_STATUS_KHR, &completed);
+
+    return completed != 0;
+}
+
+bool Shader::finish() noexcept
+{
+    if(!m_isPending)
+        return m_isLinked;
+
+    m_isPending = false;
+
+//  The status query blocks until the driver is done: with parallel compilation and isReady() polled first, it returns at once
+    const std::uint64_t start = now();
+
+    int success = 0;
+    glGetProgramiv(m_program, GL_LINK_STATUS, &success);
+
+    m_buildTime += now() - start;
+
+    if (!success)
+    {
+        char infoLog[1024]{};
+
+//      Only a failed link pays for the per-stage status queries
+        for(std::size_t i = 0; i < m_stageCount; ++i)
+        {
+            glGetShaderiv(m_stages[i], GL_COMPILE_STATUS, &success);
+
+            if(!success)
+            {
+                glGetShaderInfoLog(m_stages[i], 1024, NULL, infoLog);
+
+                std::cerr << "Error: shader compilation error\n"
+                    << infoLog << "\n -- --------------------------------------------------- -- \n";
+            }
+        }
+
+        glGetProgramInfoLog(m_program, 1024, NULL, infoLog);
+
+        std::cerr << "Error: shader program link error\n"
+            << infoLog << "\n -- --------------------------------------------------- -- \n";
+
+        releaseStages();
+
+        return false;
+    }
+
+    releaseStages();
+    m_isLinked = true;
+    ShaderCache::store(m_program, m_cacheKey, m_buildTime);
+
+    return true;
 }
 
 int Shader::getUniformLocation(const char* name) const noexcept
 {
-    if(!m_program)
+    if(!m_program || !name)
         return -1;
 
-    return glGetUniformLocation(m_program, name);
+    auto [iterator, result] = m_uniformLocations.try_emplace(StringId::hash(name), -1);
+
+    if(result)
+        iterator->second = glGetUniformLocation(m_program, name);
+
+    return iterator->second;
+}
+
+void Shader::setUniform(int location, int value) noexcept
+{
+    if(updateUniform(location, &value, sizeof(value)))
+        glProgramUniform1i(m_program, location, value);
+}
+
+void Shader::setUniform(int location, float value) noexcept
+{
+    if(updateUniform(location, &value, sizeof(value)))
+        glProgramUniform1f(m_program, location, value);
+}
+
+void Shader::setUniform(int location, const glm::vec2& value) noexcept
+{
+    if(updateUniform(location, glm::value_ptr(value), sizeof(value)))
+        glProgramUniform2fv(m_program, location, 1, glm::value_ptr(value));
+}
+
+void Shader::setUniform(int location, const glm::vec4& value) noexcept
+{
+    if(updateUniform(location, glm::value_ptr(value), sizeof(value)))
+        glProgramUniform4fv(m_program, location, 1, glm::value_ptr(value));
+}
+
+void Shader::setUniform(int location, const glm::mat4& value) noexcept
+{
+    if(updateUniform(location, glm::value_ptr(value), sizeof(value)))
+        glProgramUniformMatrix4fv(m_program, location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+Shader::UniformStatistics Shader::getUniformStatistics() noexcept
+{
+    return uniformStatistics;
+}
+
+unsigned Shader::getNativeHandle() const noexcept
+{
+    return m_program;
 }
 
 void Shader::bind(const Shader* shader) noexcept
@@ -67,60 +229,109 @@ void Shader::bind(const Shader* shader) noexcept
         glUseProgram(0);
 }
 
-std::string Shader::readShaderSourceFromFile(const std::string& filepath)
+bool Shader::isParallelCompileSupported() noexcept
 {
-    std::string source;
-
-    FILE* f = fopen(filepath.c_str(), "r");
+    static int isSupported = -1;
 
-    if (!f)
+    if(isSupported < 0)
     {
-        std::cerr << "Error: shader file not succesfully read\n";
-
-        return source;
+        isSupported = 0;
+
+        int count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+        for(int i = 0; i < count; ++i)
+        {
+            auto extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+
+            if(extension && (std::strcmp(extension, "GL_KHR_parallel_shader_compile") == 0 || std::strcmp(extension, "GL_ARB_parallel_shader_compile") == 0))
+            {
+                isSupported = 1;
+                break;
+            }
+        }
+
+#ifdef GL_KHR_parallel_shader_compile
+        if(isSupported && GLAD_GL_KHR_parallel_shader_compile)
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu); // Let the driver use as many threads as it likes
+#endif
     }
 
-    fseek(f, 0, SEEK_END);
-    size_t length = ftell(f);
+    return isSupported == 1;
+}
+
+bool Shader::startProgram(const std::string* const* filenames, const unsigned* types, std::size_t count) noexcept
+{
+    if(count > MaxStages)
+        return false;
 
-    source.resize(length + 1);
+    std::string sources[MaxStages];
 
-    fseek(f, 0, SEEK_SET);
-    fread(&source[0], sizeof(char), length, f);
-    fclose(f);
+    for(std::size_t i = 0; i < count; ++i)
+        if(!ShaderPreprocessor::process(*filenames[i], {}, sources[i]))
+            return false;
 
-    return source;
+    return startProgramFromSource(sources, types, count);
 }
 
-unsigned Shader::compileShaderFromSource(const std::string& source, unsigned type)
+bool Shader::startProgramFromSource(const std::string* sources, const unsigned* types, std::size_t count) noexcept
 {
-    unsigned shader = glCreateShader(type);
-    const char* c_str = source.c_str();
+    if(!m_program || m_isPending || count > MaxStages)
+        return false;
 
-    glShaderSource(shader, 1, &c_str, 0);
-    glCompileShader(shader);
+    const char* data[MaxStages]{};
+    std::size_t lengths[MaxStages]{};
 
-    int success = 0;
-    
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-
-    if (!success)
+    for(std::size_t i = 0; i < count; ++i)
     {
-        char infoLog[1024]{};
+        data[i]    = sources[i].data();
+        lengths[i] = sources[i].size();
+    }
 
-        glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+    m_cacheKey = ShaderCache::makeKey(data, lengths, count);
+    m_isLinked = false;
+    resetUniforms(); // A relinked program starts from its default values
 
-        std::cerr << "Error: shader compilation error\n"
-            << infoLog << "\n -- --------------------------------------------------- -- \n";
+    if(ShaderCache::load(m_program, m_cacheKey))
+        return m_isLinked = true;
+
+    isParallelCompileSupported(); // Sets the compiler thread count up before the first compile
+
+//  Only the time spent in the GL calls counts as build time, not the loading done before finish()
+    const std::uint64_t start = now();
+
+    glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
-        return 0;
+//  Nothing below waits for the driver: the statuses are checked once, in finish()
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        m_stages[i] = compileShaderFromSource(data[i], static_cast<int>(lengths[i]), types[i]);
+        glAttachShader(m_program, m_stages[i]);
     }
 
+    m_stageCount = count;
+    glLinkProgram(m_program);
+    m_isPending = true;
+    m_buildTime = now() - start;
+
+    return true;
+}
+
+unsigned Shader::compileShaderFromSource(const char* source, int length, unsigned type) noexcept
+{
+    unsigned shader = glCreateShader(type);
+
+//  The length is explicit, so the source does not have to be null-terminated
+    glShaderSource(shader, 1, &source, &length);
+    glCompileShader(shader);
+
     return shader;
 }
 
-bool Shader::linkToProgram(unsigned shader)
+bool Shader::linkToProgram(unsigned shader) noexcept
 {
+    resetUniforms();
+
     glAttachShader(m_program, shader);
     glLinkProgram(m_program); 
 
@@ -131,15 +342,62 @@ bool Shader::linkToProgram(unsigned shader)
 
     if (!success)
     {
-        glGetProgramInfoLog(shader, 1024, NULL, infoLog);
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+
+        if (!success)
+            glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+        else
+            glGetProgramInfoLog(m_program, 1024, NULL, infoLog);
 
         std::cerr << "Error: shader program link error\n"
             << infoLog << "\n -- --------------------------------------------------- -- \n";
 
+        glDetachShader(m_program, shader);
+        glDeleteShader(shader);
+
+        return m_isLinked = false;
+    }
+
+    glDeleteShader(shader); // Stays attached, so the next stage links together with this one
+
+    return m_isLinked = true;
+}
+
+void Shader::releaseStages() noexcept
+{
+    for(std::size_t i = 0; i < m_stageCount; ++i)
+    {
+        glDetachShader(m_program, m_stages[i]);
+        glDeleteShader(m_stages[i]);
+        m_stages[i] = 0u;
+    }
+
+    m_stageCount = 0u;
+}
+
+bool Shader::updateUniform(int location, const void* data, std::size_t size) noexcept
+{
+    if(!m_program || location < 0)
+        return false;
+
+    auto& cached = m_uniformValues[location];
+
+    if(cached.size == size && std::memcmp(cached.data, data, size) == 0)
+    {
+        ++uniformStatistics.elided;
+
         return false;
     }
 
-    glDeleteShader(shader);
+    std::memcpy(cached.data, data, size);
+    cached.size = size;
+    ++uniformStatistics.issued;
 
     return true;
-}
\ No newline at end of file
+}
+
+void Shader::resetUniforms() noexcept
+{
+    m_uniformLocations.clear();
+    m_uniformValues.clear();
+}
@@ -2,12 +2,24 @@
 #define SHADER_HPP
 
 #include <string>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
 
 #include "system/NonCopyable.hpp"
 
 class Shader:
     private NonCopyable
 {
+public:
+    struct UniformStatistics
+    {
+        std::uint64_t issued = 0U; // glProgramUniform* calls that reached the driver
+        std::uint64_t elided = 0U; // Calls skipped because the program already held the value
+    };
+
 public:
     Shader() noexcept;
     ~Shader();
@@ -16,16 +28,73 @@ public:
     bool compile(const std::string& filenameVert, const std::string& filenameFrag) noexcept;
     bool compile(const std::string& filenameVert, const std::string& filenameFrag, const std::string& filenameGeom) noexcept;
 
+//  Issues the compile and the single link without waiting for the driver.
+//  With GL_KHR_parallel_shader_compile many programs build concurrently; poll isReady() and call finish()
+    bool compileAsync(const std::string& filenameVert, const std::string& filenameFrag) noexcept;
+    bool compileAsync(const std::string& filenameVert, const std::string& filenameFrag, const std::string& filenameGeom) noexcept;
+
+//  Sources already in memory, e.g. expanded by ShaderPreprocessor
+    bool compileFromSource(const std::string& vertSource, const std::string& fragSource)      noexcept;
+    bool compileFromSourceAsync(const std::string& vertSource, const std::string& fragSource) noexcept;
+
+    bool isPending() const noexcept;
+    bool isReady()   const noexcept; // Never blocks when parallel compilation is supported
+    bool finish()          noexcept; // Blocks until the program is linked, reports errors. Then false while it is not linked
+
+//  Locations are queried from the driver once per name and program
     int getUniformLocation(const char* name) const noexcept;
 
+//  Values are written straight into the program, bound or not; a value equal to the last one written is skipped
+    void setUniform(int location, int value)              noexcept;
+    void setUniform(int location, float value)            noexcept;
+    void setUniform(int location, const glm::vec2& value) noexcept;
+    void setUniform(int location, const glm::vec4& value) noexcept;
+    void setUniform(int location, const glm::mat4& value) noexcept;
+
+    template<class T>
+    void setUniform(const char* name, const T& value) noexcept
+    {
+        setUniform(getUniformLocation(name), value);
+    }
+
+    static UniformStatistics getUniformStatistics() noexcept;
+
+    unsigned getNativeHandle() const noexcept;
+
     static void bind(const Shader* shader) noexcept;
 
+    static bool isParallelCompileSupported() noexcept;
+
 private:
-    std::string readShaderSourceFromFile(const std::string& filename);
-    unsigned    compileShaderFromSource(const std::string& source, unsigned type);
-    bool        linkToProgram(unsigned shader);
+    static constexpr std::size_t MaxStages = 3;
+
+//  Goes through the binary cache first, otherwise compiles every stage and links once
+    bool     startProgram(const std::string* const* filenames, const unsigned* types, std::size_t count) noexcept;
+    bool     startProgramFromSource(const std::string* sources, const unsigned* types, std::size_t count) noexcept;
+    unsigned compileShaderFromSource(const char* source, int length, unsigned type) noexcept;
+    bool     linkToProgram(unsigned shader) noexcept;
+    void     releaseStages() noexcept;
+
+//  False if the location already holds these bytes
+    bool     updateUniform(int location, const void* data, std::size_t size) noexcept;
+    void     resetUniforms() noexcept;
 
 private:
-    unsigned m_program;
+    struct UniformValue
+    {
+        float       data[16];
+        std::size_t size = 0U;
+    };
+
+    mutable std::unordered_map<std::uint64_t, int> m_uniformLocations; // Name hash -> location
+    std::unordered_map<int, UniformValue>          m_uniformValues;
+
+    unsigned      m_program;
+    unsigned      m_stages[MaxStages];
+    std::size_t   m_stageCount;
+    std::uint64_t m_cacheKey;
+    std::uint64_t m_buildTime; // Nanoseconds the GL thread spent issuing the build and waiting for it
+    bool          m_isPending;
+    bool          m_isLinked;
 };
-#endif
\ No newline at end of file
+#endif
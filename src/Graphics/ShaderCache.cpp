@@ -0,0 +1,225 @@
+#include <glad/glad.h>
+
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+
+#include "graphics/ShaderCache.hpp"
+
+namespace
+{
+    struct EntryHeader
+    {
+        std::uint32_t magic         = 0x48435350; // "PSCH"
+        std::uint32_t format        = 0U;         // Binary format reported by the driver
+        std::uint64_t key           = 0U;
+        std::uint64_t compileTimeNs = 0U;         // How long building this program from source took
+        std::uint64_t length        = 0U;
+    };
+
+//  Far above any real program binary, and below the INT_MAX a GLsizei holds
+    constexpr std::uint64_t MaxBinaryLength = 64ULL << 20;
+
+    struct CacheState
+    {
+        std::string directory = std::filesystem::current_path().string() + "/shader_cache";
+        bool isEnabled        = true;
+        int  isSupported      = -1; // Not queried yet
+
+        ShaderCache::Statistics stats;
+    };
+
+    CacheState& getState() noexcept
+    {
+        static CacheState state;
+
+        return state;
+    }
+
+    std::uint64_t hashBytes(std::uint64_t hash, const char* data, std::size_t length) noexcept
+    {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    std::uint64_t hashString(std::uint64_t hash, const unsigned char* str) noexcept
+    {
+        const char* text = reinterpret_cast<const char*>(str);
+
+        return text ? hashBytes(hash, text, std::char_traits<char>::length(text) + 1) : hash;
+    }
+
+    std::uint64_t elapsedSince(std::chrono::steady_clock::time_point start) noexcept
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+std::uint64_t ShaderCache::makeKey(const char* const* sources, const std::size_t* lengths, std::size_t count) noexcept
+{
+    std::uint64_t key = 14695981039346656037ULL;
+
+    key = hashString(key, glGetString(GL_VENDOR));
+    key = hashString(key, glGetString(GL_RENDERER));
+    key = hashString(key, glGetString(GL_VERSION));
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        key = hashBytes(key, sources[i], lengths[i]);
+        key = hashBytes(key, "\0", 1); // Keep the stage boundaries part of the key
+    }
+
+    return key;
+}
+
+bool ShaderCache::load(unsigned program, std::uint64_t key) noexcept
+{
+    auto& state = getState();
+
+    if (!state.isEnabled || !isSupported())
+        return false;
+
+    auto start = std::chrono::steady_clock::now();
+
+    const std::string path = getEntryPath(key);
+
+    std::error_code ec;
+    const std::uintmax_t fileSize = std::filesystem::file_size(path, ec);
+
+    if (ec)
+    {
+        ++state.stats.misses;
+
+        return false;
+    }
+
+    EntryHeader header;
+    bool isValid = false;
+
+    {
+        std::ifstream file(path, std::ios::binary);
+
+//      The length comes from disk: it must be exactly the rest of the entry, and fit a GLsizei,
+//      before anything is allocated for it
+        if (file && file.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == EntryHeader().magic && header.key == key
+            && header.length > 0U && header.length <= MaxBinaryLength && header.length == fileSize - sizeof(header))
+        {
+            std::vector<char> binary(static_cast<std::size_t>(header.length));
+
+            if (file.read(binary.data(), static_cast<std::streamsize>(binary.size())))
+            {
+                glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+                int success = 0;
+                glGetProgramiv(program, GL_LINK_STATUS, &success);
+                isValid = (success != 0);
+            }
+        }
+    }
+
+    if (!isValid)
+    {
+//      A corrupt entry, or one the driver rejects, would fail the same way on every start: drop it so the
+//      program built from source is stored in its place
+        std::filesystem::remove(path, ec);
+        ++state.stats.misses;
+
+        return false;
+    }
+
+    const std::uint64_t loadTime = elapsedSince(start);
+
+    ++state.stats.hits;
+    state.stats.loadTimeNs  += loadTime;
+    state.stats.savedTimeNs += (header.compileTimeNs > loadTime) ? header.compileTimeNs - loadTime : 0U;
+
+    return true;
+}
+
+void ShaderCache::store(unsigned program, std::uint64_t key, std::uint64_t compileTimeNs) noexcept
+{
+    auto& state = getState();
+    state.stats.compileTimeNs += compileTimeNs;
+
+    if (!state.isEnabled || !isSupported())
+        return;
+
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if (length <= 0 || static_cast<std::uint64_t>(length) > MaxBinaryLength)
+        return;
+
+    std::vector<char> binary(static_cast<std::size_t>(length));
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    EntryHeader header;
+    header.format        = format;
+    header.key           = key;
+    header.compileTimeNs = compileTimeNs;
+    header.length        = static_cast<std::uint64_t>(length);
+
+    std::error_code ec;
+    std::filesystem::create_directories(state.directory, ec);
+
+//  Write to a temporary file first, so a crash never leaves a truncated entry behind
+    const std::string path = getEntryPath(key);
+    const std::string temp = path + ".tmp";
+
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+
+        if (!file.write(reinterpret_cast<const char*>(&header), sizeof(header)) || !file.write(binary.data(), length))
+            return;
+    }
+
+    std::filesystem::rename(temp, path, ec);
+
+    if (!ec)
+        ++state.stats.stores;
+}
+
+void ShaderCache::setDirectory(const std::string& directory) noexcept
+{
+    getState().directory = directory;
+}
+
+void ShaderCache::setEnabled(bool enabled) noexcept
+{
+    getState().isEnabled = enabled;
+}
+
+ShaderCache::Statistics ShaderCache::getStatistics() noexcept
+{
+    return getState().stats;
+}
+
+std::string ShaderCache::getEntryPath(std::uint64_t key) noexcept
+{
+    char name[32]{};
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+
+    return getState().directory + '/' + name;
+}
+
+bool ShaderCache::isSupported() noexcept
+{
+    auto& state = getState();
+
+    if (state.isSupported < 0)
+    {
+        int formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        state.isSupported = (formats > 0) ? 1 : 0;
+    }
+
+    return state.isSupported == 1;
+}
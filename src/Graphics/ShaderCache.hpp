@@ -0,0 +1,40 @@
+#ifndef SHADER_CACHE_HPP
+#define SHADER_CACHE_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary).
+// Entries are keyed by the shader sources and by the driver vendor, renderer and version,
+// so a driver update or an edited source simply misses and the program is rebuilt from source.
+class ShaderCache
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t hits          = 0U;
+        std::uint64_t misses        = 0U;
+        std::uint64_t stores        = 0U;
+        std::uint64_t compileTimeNs = 0U; // Spent by the GL thread building programs from source
+        std::uint64_t loadTimeNs    = 0U; // Spent loading binaries
+        std::uint64_t savedTimeNs   = 0U; // Recorded compile time of the hits minus their load time
+    };
+
+public:
+    static std::uint64_t makeKey(const char* const* sources, const std::size_t* lengths, std::size_t count) noexcept;
+
+    static bool load(unsigned program, std::uint64_t key) noexcept;
+    static void store(unsigned program, std::uint64_t key, std::uint64_t compileTimeNs) noexcept;
+
+    static void setDirectory(const std::string& directory) noexcept;
+    static void setEnabled(bool enabled) noexcept;
+
+    static Statistics getStatistics() noexcept;
+
+private:
+    static std::string getEntryPath(std::uint64_t key) noexcept;
+    static bool        isSupported() noexcept;
+};
+
+#endif // !SHADER_CACHE_HPP
@@ -0,0 +1,138 @@
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+
+#include "system/FileProvider.hpp"
+#include "graphics/ShaderPreprocessor.hpp"
+
+namespace
+{
+    constexpr int MaxIncludeDepth = 32;
+
+//  Returns the directive name of a preprocessor line ("include", "version", ...) or an empty string
+    std::string getDirective(const char* line, const char* end, const char** rest) noexcept
+    {
+        while (line < end && (*line == ' ' || *line == '\t'))
+            ++line;
+
+        if (line == end || *line != '#')
+            return {};
+
+        ++line;
+
+        while (line < end && (*line == ' ' || *line == '\t'))
+            ++line;
+
+        const char* name = line;
+
+        while (line < end && std::isalpha(static_cast<unsigned char>(*line)))
+            ++line;
+
+        *rest = line;
+
+        return std::string(name, line);
+    }
+}
+
+bool ShaderPreprocessor::process(const std::string& filename, const std::vector<std::string>& defines, std::string& output) noexcept
+{
+    std::vector<std::string> included;
+    output.clear();
+
+    return append(filename, &defines, included, output, 0);
+}
+
+bool ShaderPreprocessor::append(const std::string& filename, const std::vector<std::string>* defines,
+                                std::vector<std::string>& included, std::string& output, int depth) noexcept
+{
+    if (depth > MaxIncludeDepth)
+    {
+        std::cerr << "Error: shader include depth exceeded in " << filename << '\n';
+
+        return false;
+    }
+
+    if (std::find(included.begin(), included.end(), filename) != included.end())
+        return true; // Already expanded
+
+    included.push_back(filename);
+
+    const FileView file = FileProvider().getFileView(filename);
+
+    if (file.empty())
+    {
+        std::cerr << "Error: shader file " << filename << " not found\n";
+
+        return false;
+    }
+
+    const char* ptr = file.data();
+    const char* end = ptr + file.size();
+    int lineNumber  = 0;
+
+    output.reserve(output.size() + file.size());
+
+    while (ptr < end)
+    {
+        const char* lineEnd = std::find(ptr, end, '\n');
+        const char* rest    = nullptr;
+        ++lineNumber;
+
+        const std::string directive = getDirective(ptr, lineEnd, &rest);
+
+        if (directive == "include")
+        {
+            const char* open  = std::find_if(rest, lineEnd, [](char c) { return c == '"' || c == '<'; });
+            const char* close = (open != lineEnd) ? std::find_if(open + 1, lineEnd, [](char c) { return c == '"' || c == '>'; }) : lineEnd;
+
+            if (close == lineEnd)
+            {
+                std::cerr << "Error: malformed #include in " << filename << ", line " << lineNumber << '\n';
+
+                return false;
+            }
+
+            std::string name(open + 1, close);
+
+            if (std::size_t last_slash_pos = name.find_last_of('/'); last_slash_pos != std::string::npos)
+                name.erase(0, last_slash_pos + 1); // Resources are looked up by file name
+
+            output += "#line 1\n";
+
+            if (!append(name, nullptr, included, output, depth + 1))
+                return false;
+
+            output += "#line " + std::to_string(lineNumber + 1) + '\n';
+        }
+        else
+        {
+            output.append(ptr, lineEnd);
+            output += '\n';
+
+//          The defines must follow #version, which has to come first in GLSL
+            if (defines && directive == "version")
+            {
+                for (const auto& define : *defines)
+                    output += "#define " + define + '\n';
+
+                output += "#line " + std::to_string(lineNumber + 1) + '\n';
+                defines = nullptr;
+            }
+        }
+
+        ptr = (lineEnd < end) ? lineEnd + 1 : end;
+    }
+
+    if (defines && !defines->empty())
+    {
+//      No #version line: the defines go first
+        std::string prefix;
+
+        for (const auto& define : *defines)
+            prefix += "#define " + define + '\n';
+
+        output.insert(0, prefix);
+    }
+
+    return true;
+}
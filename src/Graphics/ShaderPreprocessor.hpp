@@ -0,0 +1,20 @@
+#ifndef SHADER_PREPROCESSOR_HPP
+#define SHADER_PREPROCESSOR_HPP
+
+#include <string>
+#include <vector>
+
+// Expands #include "file" directives (every file is included at most once) and
+// injects a #define for each entry of defines right after the #version line.
+// Entries are either "NAME" or "NAME VALUE".
+class ShaderPreprocessor
+{
+public:
+    static bool process(const std::string& filename, const std::vector<std::string>& defines, std::string& output) noexcept;
+
+private:
+    static bool append(const std::string& filename, const std::vector<std::string>* defines,
+                       std::vector<std::string>& included, std::string& output, int depth) noexcept;
+};
+
+#endif // !SHADER_PREPROCESSOR_HPP
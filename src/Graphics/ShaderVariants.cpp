@@ -0,0 +1,147 @@
+#include <iostream>
+#include <utility>
+
+#include "graphics/Shader.hpp"
+#include "graphics/ShaderPreprocessor.hpp"
+#include "graphics/ShaderVariants.hpp"
+
+ShaderVariants::ShaderVariants() noexcept:
+    m_usedMask(0U)
+{
+}
+
+ShaderVariants::~ShaderVariants()
+{
+}
+
+bool ShaderVariants::create(const std::string& vert, const std::string& frag, const std::vector<std::string>& features) noexcept
+{
+    if (features.size() > MaxFeatures)
+        return false;
+
+    m_variants.clear();
+    m_programs.clear();
+    m_featureIds.clear();
+
+    m_vert     = vert;
+    m_frag     = frag;
+    m_features = features;
+
+//  A feature is "NAME" or "NAME VALUE": masks are asked by name, the whole string goes into the #define
+    for (const auto& feature : m_features)
+        m_featureIds.emplace_back(feature.substr(0, feature.find(' ')));
+
+    std::string vertSource;
+    std::string fragSource;
+
+    if (!ShaderPreprocessor::process(m_vert, {}, vertSource) || !ShaderPreprocessor::process(m_frag, {}, fragSource))
+        return false;
+
+//  A feature the sources never mention can not change the program, so it is dropped from every mask
+    m_usedMask = 0U;
+
+    for (std::size_t i = 0; i < m_features.size(); ++i)
+    {
+        const char* name = m_featureIds[i].c_str();
+
+        if (vertSource.find(name) != std::string::npos || fragSource.find(name) != std::string::npos)
+            m_usedMask |= 1U << i;
+    }
+
+    return true;
+}
+
+std::uint32_t ShaderVariants::getMask(std::initializer_list<StringId> features) const noexcept
+{
+    std::uint32_t mask = 0U;
+
+    for (const auto& feature : features)
+    {
+        bool isKnown = false;
+
+        for (std::size_t i = 0; i < m_featureIds.size(); ++i)
+            if (m_featureIds[i] == feature)
+            {
+                mask |= 1U << i;
+                isKnown = true;
+            }
+
+        if (!isKnown)
+            std::cerr << "Warning: unknown shader feature " << feature.c_str() << '\n';
+    }
+
+    return mask;
+}
+
+Shader* ShaderVariants::get(std::uint32_t mask) noexcept
+{
+    if (auto found = m_variants.find(mask); found != m_variants.end())
+        return found->second;
+
+    const std::uint32_t requested = mask;
+    mask &= m_usedMask;
+
+    if (auto found = m_variants.find(mask); found != m_variants.end())
+    {
+        m_variants.emplace(requested, found->second);
+
+        return found->second;
+    }
+
+    std::vector<std::string> defines;
+
+    for (std::size_t i = 0; i < m_features.size(); ++i)
+        if (mask & (1U << i))
+            defines.push_back(m_features[i]);
+
+    std::string vertSource;
+    std::string fragSource;
+
+    if (!ShaderPreprocessor::process(m_vert, defines, vertSource) || !ShaderPreprocessor::process(m_frag, defines, fragSource))
+        return nullptr;
+
+//  Different masks can still expand to the same code. The hash only finds the candidates,
+//  a program is shared when both of its sources are equal
+    const std::uint64_t vertHash = StringId::hash(vertSource.c_str());
+    const std::uint64_t hash     = vertHash ^ (StringId::hash(fragSource.c_str()) + 0x9E3779B97F4A7C15ULL + (vertHash << 6) + (vertHash >> 2));
+
+    Shader* program = nullptr;
+
+    for (auto [it, end] = m_programs.equal_range(hash); it != end; ++it)
+        if (it->second.vertSource == vertSource && it->second.fragSource == fragSource)
+        {
+            program = it->second.shader.get();
+            break;
+        }
+
+    if (!program)
+    {
+        auto shader = std::make_unique<Shader>();
+
+        if (!shader->compileFromSource(vertSource, fragSource))
+            return nullptr;
+
+        program = shader.get();
+        m_programs.emplace(hash, Program { std::move(vertSource), std::move(fragSource), std::move(shader) });
+    }
+
+    m_variants.emplace(mask, program);
+    m_variants.emplace(requested, program);
+
+    return program;
+}
+
+Shader* ShaderVariants::get(std::initializer_list<StringId> features) noexcept
+{
+    return get(getMask(features));
+}
+
+std::size_t ShaderVariants::getVariantCount() const noexcept
+{
+    return m_variants.size();
+}
+
+std::size_t ShaderVariants::getProgramCount() const noexcept
+{
+    return m_programs.size();
+}
@@ -0,0 +1,56 @@
+#ifndef SHADER_VARIANTS_HPP
+#define SHADER_VARIANTS_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <initializer_list>
+#include <cstdint>
+
+#include "system/NonCopyable.hpp"
+#include "system/StringId.hpp"
+
+// A named set of feature toggles over one vertex/fragment pair.
+// Every combination of features becomes its own program with the matching #defines,
+// so disabled features cost no dynamic branches. Programs are built on first use,
+// and combinations that expand to the same sources share one program.
+class ShaderVariants:
+    private NonCopyable
+{
+public:
+    static constexpr std::size_t MaxFeatures = 32;
+
+public:
+    ShaderVariants() noexcept;
+    ~ShaderVariants();
+
+    bool create(const std::string& vert, const std::string& frag, const std::vector<std::string>& features) noexcept;
+
+    std::uint32_t getMask(std::initializer_list<StringId> features) const noexcept;
+
+    class Shader* get(std::uint32_t mask) noexcept;
+    class Shader* get(std::initializer_list<StringId> features) noexcept;
+
+    std::size_t getVariantCount() const noexcept; // Combinations requested so far
+    std::size_t getProgramCount() const noexcept; // Distinct programs behind them
+
+private:
+    std::string              m_vert;
+    std::string              m_frag;
+    std::vector<std::string> m_features;
+    std::vector<StringId>    m_featureIds;
+    std::uint32_t            m_usedMask; // Features the expanded sources actually mention
+
+    struct Program
+    {
+        std::string                   vertSource;
+        std::string                   fragSource;
+        std::unique_ptr<class Shader> shader;
+    };
+
+    std::unordered_map<std::uint32_t, class Shader*> m_variants; // mask -> program
+    std::unordered_multimap<std::uint64_t, Program>  m_programs; // source hash -> programs, told apart by their sources
+};
+
+#endif // !SHADER_VARIANTS_HPP
@@ -1,12 +1,25 @@
 #ifndef SPRITE2D_HPP
 #define SPRITE2D_HPP
 
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "graphics/SpriteOutline.hpp"
+
 struct Sprite2D
 {
-	unsigned texture = 0U;
-	unsigned frame   = 0U;
-	unsigned width   = 0U;
-	unsigned height  = 0U;
+	unsigned  texture = 0U;
+	unsigned  frame   = 0U;
+	unsigned  width   = 0U;
+	unsigned  height  = 0U;
+	glm::vec4 texCoords { 0.0f }; // left, top, right, bottom; lets SpriteBatch build the quad without the vertex buffer
+
+	std::uint32_t index       = 0U; // Into the frame table of SpriteManager
+	std::uint32_t vertexCount = 0U; // Of the frame's mesh: 4, or SpriteOutline::MaxVertices for trimmed polygons. 0 without a mesh
+
+//	Copied from the frame, so the sprite stays valid whatever is loaded afterwards. The full quad for untrimmed frames
+	glm::u16vec2 outline[SpriteOutline::MaxVertices] {}; // vertexCount points in pixels
 };
 
 bool operator == (const Sprite2D& a, const Sprite2D& b) noexcept;
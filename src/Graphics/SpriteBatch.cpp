@@ -0,0 +1,340 @@
+#include <glad/glad.h>
+
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+#include "graphics/Shader.hpp"
+#include "graphics/Transform2D.hpp"
+#include "graphics/RenderQueue.hpp"
+#include "graphics/SpriteOutline.hpp"
+#include "graphics/SpriteBatch.hpp"
+
+SpriteBatch::SpriteBatch() noexcept:
+    m_vao(0u),
+    m_polygonVao(0u),
+    m_vbo(0u),
+    m_capacity(0u),
+    m_cursor(0u),
+    m_isDrawing(false)
+{
+}
+
+SpriteBatch::~SpriteBatch()
+{
+    if(m_vao)
+        glDeleteVertexArrays(1, &m_vao);
+
+    if(m_polygonVao)
+        glDeleteVertexArrays(1, &m_polygonVao);
+
+    if(m_vbo)
+        glDeleteBuffers(1, &m_vbo);
+}
+
+bool SpriteBatch::create(std::size_t capacity) noexcept
+{
+    if(m_vao || capacity == 0U)
+        return false;
+
+    if(!m_quadIndices.create() || !m_polygonIndices.create(SpriteOutline::MaxVertices))
+        return false;
+
+    glGenVertexArrays(1, &m_vao);
+    glGenVertexArrays(1, &m_polygonVao);
+    glGenBuffers(1, &m_vbo);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity * 4U * sizeof(Vertex)), nullptr, GL_STREAM_DRAW);
+
+//  Both vertex arrays read the same vertices, they only differ in the element buffer
+    for(auto [vao, indices] : { std::make_pair(m_vao, &m_quadIndices), std::make_pair(m_polygonVao, &m_polygonIndices) })
+    {
+        glBindVertexArray(vao);
+
+        indices->bind();
+
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+        glEnableVertexAttribArray(0);
+
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+        glEnableVertexAttribArray(1);
+
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+        glEnableVertexAttribArray(2);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    m_capacity = capacity * 4U;
+    m_cursor   = 0U;
+    m_commands.m_vertices.reserve(capacity * 4U);
+
+    return true;
+}
+
+void SpriteBatch::CommandBuffer::setShader(const Shader* shader) noexcept
+{
+    m_shader = shader;
+}
+
+void SpriteBatch::CommandBuffer::draw(const Sprite2D& sprite, const Transform2D& transform, const Color& tint) noexcept
+{
+    draw(sprite, transform.getAffine(), tint);
+}
+
+void SpriteBatch::CommandBuffer::draw(const Sprite2D& sprite, const glm::mat4& matrix, const Color& tint) noexcept
+{
+    draw(sprite, Affine2D::fromMatrix(matrix), tint);
+}
+
+void SpriteBatch::CommandBuffer::draw(const Sprite2D& sprite, const Affine2D& affine, const Color& tint) noexcept
+{
+    if(!sprite.texture)
+        return;
+
+    const std::uint32_t corners = (sprite.vertexCount > 4U) ? SpriteOutline::MaxVertices : 4U;
+    const auto          vertex  = static_cast<std::uint32_t>(m_vertices.size());
+
+    if(m_runs.empty() || m_runs.back().texture != sprite.texture || m_runs.back().shader != m_shader || m_runs.back().corners != corners)
+        m_runs.push_back({ m_shader, sprite.texture, corners, vertex, 0U });
+
+    ++m_runs.back().count;
+
+//  The corners are the translation plus the basis vectors scaled to the sprite
+    const glm::vec2 origin(affine.translation);
+    const glm::vec2 axisX(affine.axisX.x * sprite.width,  affine.axisX.y * sprite.width);
+    const glm::vec2 axisY(affine.axisY.x * sprite.height, affine.axisY.y * sprite.height);
+
+    const auto& uv = sprite.texCoords;
+
+    if(sprite.vertexCount == 0U)
+    {
+        m_vertices.push_back({ origin,                 glm::vec2(uv.x, uv.y), tint });
+        m_vertices.push_back({ origin + axisX,         glm::vec2(uv.z, uv.y), tint });
+        m_vertices.push_back({ origin + axisX + axisY, glm::vec2(uv.z, uv.w), tint });
+        m_vertices.push_back({ origin + axisY,         glm::vec2(uv.x, uv.w), tint });
+
+        return;
+    }
+
+//  The outline is in pixels of the frame, the same fraction of the axes and of the texture rectangle
+    const glm::vec2 scale(1.0f / sprite.width, 1.0f / sprite.height);
+
+    for(std::uint32_t i = 0; i < corners; ++i)
+    {
+        const auto& point = sprite.outline[std::min(i, sprite.vertexCount - 1U)];
+        const float x     = point.x * scale.x;
+        const float y     = point.y * scale.y;
+
+        m_vertices.push_back({ origin + axisX * x + axisY * y, glm::vec2(uv.x + (uv.z - uv.x) * x, uv.y + (uv.w - uv.y) * y), tint });
+    }
+}
+
+void SpriteBatch::CommandBuffer::clear() noexcept
+{
+    m_vertices.clear();
+    m_runs.clear();
+}
+
+std::size_t SpriteBatch::CommandBuffer::getSpriteCount() const noexcept
+{
+    std::size_t count = 0U;
+
+    for(const auto& run : m_runs)
+        count += run.count;
+
+    return count;
+}
+
+void SpriteBatch::begin(const Shader* shader) noexcept
+{
+    m_commands.clear();
+    m_commands.setShader(shader);
+    m_frame     = Statistics();
+    m_isDrawing = true;
+}
+
+void SpriteBatch::setShader(const Shader* shader) noexcept
+{
+    m_commands.setShader(shader);
+}
+
+void SpriteBatch::draw(const Sprite2D& sprite, const Transform2D& transform, const Color& tint) noexcept
+{
+    if(m_isDrawing)
+        m_commands.draw(sprite, transform.getAffine(), tint);
+}
+
+void SpriteBatch::draw(const Sprite2D& sprite, const glm::mat4& matrix, const Color& tint) noexcept
+{
+    if(m_isDrawing)
+        m_commands.draw(sprite, Affine2D::fromMatrix(matrix), tint);
+}
+
+void SpriteBatch::draw(const Sprite2D& sprite, const Affine2D& affine, const Color& tint) noexcept
+{
+    if(m_isDrawing)
+        m_commands.draw(sprite, affine, tint);
+}
+
+void SpriteBatch::append(const CommandBuffer& commands) noexcept
+{
+    if(!m_isDrawing || commands.m_vertices.empty())
+        return;
+
+    auto& vertices = m_commands.m_vertices;
+    auto& runs     = m_commands.m_runs;
+    auto  offset   = static_cast<std::uint32_t>(vertices.size());
+
+    vertices.insert(vertices.end(), commands.m_vertices.begin(), commands.m_vertices.end());
+
+    for(const auto& run : commands.m_runs)
+    {
+//      A run continuing the last one of the batch joins it, so splitting the work between threads costs no draw calls
+        if(!runs.empty() && runs.back().texture == run.texture && runs.back().shader == run.shader && runs.back().corners == run.corners &&
+           runs.back().first + runs.back().count * run.corners == offset + run.first)
+            runs.back().count += run.count;
+        else
+            runs.push_back({ run.shader, run.texture, run.corners, offset + run.first, run.count });
+    }
+}
+
+void SpriteBatch::end() noexcept
+{
+    flush(nullptr, 0U, 0U);
+}
+
+void SpriteBatch::end(RenderQueue& queue, std::uint8_t layer, std::uint16_t depth) noexcept
+{
+    flush(&queue, layer, depth);
+}
+
+const SpriteBatch::Statistics& SpriteBatch::getStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+void SpriteBatch::flush(RenderQueue* queue, std::uint8_t layer, std::uint16_t depth) noexcept
+{
+    if(!m_isDrawing)
+        return;
+
+    m_isDrawing = false;
+
+    if(!m_commands.m_vertices.empty() && upload())
+    {
+        const Shader* shader  = nullptr;
+        unsigned      texture = 0U;
+        unsigned      vao     = 0U;
+
+        for(const auto& run : m_commands.m_runs)
+        {
+            const PolygonIndexBuffer& indices = (run.corners == 4U) ? m_quadIndices : m_polygonIndices;
+            const unsigned            runVao  = (run.corners == 4U) ? m_vao : m_polygonVao;
+
+            if(!queue && runVao != vao)
+            {
+                vao = runVao;
+                glBindVertexArray(vao);
+            }
+
+            if(!queue && run.shader != shader)
+            {
+                shader = run.shader;
+                Shader::bind(shader);
+            }
+
+            if(!queue && run.texture != texture)
+            {
+                texture = run.texture;
+                glBindTexture(GL_TEXTURE_2D, texture);
+            }
+
+            for(std::uint32_t done = 0; done < run.count; )
+            {
+                auto count = static_cast<std::uint32_t>(std::min<std::size_t>(run.count - done, indices.getMaxPolygons()));
+                auto base  = static_cast<GLint>(m_cursor + run.first + done * run.corners);
+
+                if(queue)
+                {
+                    DrawPacket packet;
+                    packet.shader     = run.shader;
+                    packet.texture    = run.texture;
+                    packet.vao        = runVao;
+                    packet.mode       = GL_TRIANGLES;
+                    packet.count      = count * indices.getIndicesPerPolygon();
+                    packet.indexType  = GL_UNSIGNED_SHORT;
+                    packet.baseVertex = base;
+
+                    queue->submit(packet, layer, depth);
+                }
+                else
+                {
+                    glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(count * indices.getIndicesPerPolygon()), GL_UNSIGNED_SHORT, nullptr, base);
+                }
+
+                ++m_frame.drawCalls;
+                done += count;
+            }
+        }
+
+        if(!queue)
+        {
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glBindVertexArray(0);
+            Shader::bind(nullptr);
+        }
+
+        m_frame.sprites  = static_cast<std::uint32_t>(m_commands.getSpriteCount());
+        m_frame.vertices = static_cast<std::uint32_t>(m_commands.m_vertices.size());
+        m_cursor += m_commands.m_vertices.size();
+    }
+
+    m_statistics = m_frame;
+}
+
+bool SpriteBatch::upload() noexcept
+{
+    if(!m_vbo)
+        return false;
+
+    const std::size_t count = m_commands.m_vertices.size();
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    if(count > m_capacity)
+    {
+        m_capacity = std::max(count, m_capacity * 2U);
+        m_cursor   = 0U;
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_capacity * sizeof(Vertex)), nullptr, GL_STREAM_DRAW);
+    }
+    else if(m_cursor + count > m_capacity)
+    {
+//      Orphaning: the driver hands out fresh storage while the previous frames are still being read
+        m_cursor = 0U;
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_capacity * sizeof(Vertex)), nullptr, GL_STREAM_DRAW);
+    }
+
+    const auto offset = static_cast<GLintptr>(m_cursor * sizeof(Vertex));
+    const auto size   = static_cast<GLsizeiptr>(m_commands.m_vertices.size() * sizeof(Vertex));
+
+//  The range past the cursor is not used by any draw in flight, so there is nothing to wait for
+    void* memory = glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+    if(!memory)
+    {
+        std::cerr << "Error: failed to map the sprite batch vertex buffer\n";
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        return false;
+    }
+
+    std::memcpy(memory, m_commands.m_vertices.data(), static_cast<std::size_t>(size));
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return true;
+}
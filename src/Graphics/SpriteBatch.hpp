@@ -0,0 +1,118 @@
+#ifndef SPRITE_BATCH_HPP
+#define SPRITE_BATCH_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "system/NonCopyable.hpp"
+#include "graphics/Color.hpp"
+#include "graphics/Affine2D.hpp"
+#include "graphics/Sprite2D.hpp"
+#include "graphics/PolygonIndexBuffer.hpp"
+
+// Collects the sprites of a frame as already transformed quads and draws them with one indexed call
+// per run of sprites sharing a texture and a shader. The vertices of a frame are written into a
+// streaming buffer with a single unsynchronized map; the buffer is orphaned when it wraps around.
+// Sprites with an outline from SpriteManager are written as their trimmed polygon, padded to
+// SpriteOutline::MaxVertices corners, and drawn with a second shared index pattern.
+// Meant for batch.vert / batch.frag with VERTEX_TINT, which read the view from the FrameData block.
+class SpriteBatch:
+    private NonCopyable
+{
+private:
+    struct Vertex
+    {
+        glm::vec2 position;
+        glm::vec2 texCoords;
+        Color     color;
+    };
+
+    struct Run
+    {
+        const class Shader* shader  = nullptr;
+        unsigned            texture = 0U;
+        std::uint32_t       corners = 4U; // Of every sprite in the run
+        std::uint32_t       first   = 0U; // In vertices
+        std::uint32_t       count   = 0U; // In sprites
+    };
+
+public:
+    struct Statistics
+    {
+        std::uint32_t sprites   = 0U;
+        std::uint32_t drawCalls = 0U;
+        std::uint32_t vertices  = 0U;
+    };
+
+//  Recording context with no GL state: one per thread, filled in parallel and appended to the batch on the GL thread
+    class CommandBuffer
+    {
+    public:
+        void setShader(const class Shader* shader) noexcept; // Starts a new run at the next sprite
+
+        void draw(const Sprite2D& sprite, const class Transform2D& transform, const Color& tint = Color::White) noexcept;
+        void draw(const Sprite2D& sprite, const glm::mat4& matrix, const Color& tint = Color::White)            noexcept;
+        void draw(const Sprite2D& sprite, const Affine2D& affine, const Color& tint = Color::White)             noexcept;
+
+        void        clear()          noexcept;
+        std::size_t getSpriteCount() const noexcept;
+
+    private:
+        friend class SpriteBatch;
+
+        std::vector<Vertex> m_vertices;
+        std::vector<Run>    m_runs;
+        const class Shader* m_shader = nullptr;
+    };
+
+public:
+    SpriteBatch() noexcept;
+    ~SpriteBatch();
+
+//  Capacity in quads (trimmed sprites take up to two); the buffer grows if a frame needs more
+    bool create(std::size_t capacity = 4096U) noexcept;
+
+    void begin(const class Shader* shader) noexcept;
+    void setShader(const class Shader* shader) noexcept; // Starts a new run at the next sprite
+
+    void draw(const Sprite2D& sprite, const class Transform2D& transform, const Color& tint = Color::White) noexcept;
+    void draw(const Sprite2D& sprite, const glm::mat4& matrix, const Color& tint = Color::White)            noexcept;
+    void draw(const Sprite2D& sprite, const Affine2D& affine, const Color& tint = Color::White)             noexcept;
+
+//  Appends the sprites recorded by another thread after the ones already in the batch
+    void append(const CommandBuffer& commands) noexcept;
+
+//  Uploads the frame and issues the draws. Leaves no program, texture or vertex array bound
+    void end() noexcept;
+
+//  Uploads the frame and submits one packet per draw instead. Runs of different textures may then be
+//  reordered by the queue; give the batches distinct depths where the overlap order matters
+    void end(class RenderQueue& queue, std::uint8_t layer, std::uint16_t depth = 0U) noexcept;
+
+    const Statistics& getStatistics() const noexcept; // Of the last finished frame
+
+private:
+    void flush(class RenderQueue* queue, std::uint8_t layer, std::uint16_t depth) noexcept;
+    bool upload() noexcept;
+
+private:
+    CommandBuffer m_commands;
+
+    PolygonIndexBuffer m_quadIndices;
+    PolygonIndexBuffer m_polygonIndices; // SpriteOutline::MaxVertices corners
+
+    unsigned    m_vao;        // Quads
+    unsigned    m_polygonVao; // Same vertices, polygon indices
+    unsigned    m_vbo;
+    std::size_t m_capacity; // Vertices the vertex buffer holds
+    std::size_t m_cursor;   // First free vertex since the last orphaning
+
+    Statistics m_frame;
+    Statistics m_statistics;
+    bool       m_isDrawing;
+};
+
+#endif // !SPRITE_BATCH_HPP
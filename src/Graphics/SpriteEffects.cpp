@@ -0,0 +1,261 @@
+#include <glad/glad.h>
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "graphics/Shader.hpp"
+#include "graphics/Transform2D.hpp"
+#include "graphics/RenderQueue.hpp"
+#include "graphics/SpriteOutline.hpp"
+#include "graphics/SpriteEffects.hpp"
+
+SpriteEffects::SpriteEffects() noexcept:
+    m_effectBuffer(GL_SHADER_STORAGE_BUFFER, GL_DYNAMIC_DRAW),
+    m_clipTable(GL_SHADER_STORAGE_BUFFER, GL_DYNAMIC_DRAW),
+    m_uploadedEffects(0u),
+    m_epoch(0.0),
+    m_vao(0u)
+{
+}
+
+SpriteEffects::~SpriteEffects()
+{
+    if(m_vao)
+        glDeleteVertexArrays(1, &m_vao);
+}
+
+bool SpriteEffects::create() noexcept
+{
+    if(m_vao)
+        return false;
+
+    glGenVertexArrays(1, &m_vao);
+
+    return m_vao != 0U;
+}
+
+void SpriteEffects::setClips(const AnimationSystem& system) noexcept
+{
+    const auto& clips = system.getClips();
+
+    if(clips.size() <= m_clips.size())
+        return;
+
+    std::vector<ClipData> table;
+    table.reserve(clips.size() - m_clips.size());
+
+    for(std::size_t i = m_clips.size(); i < clips.size(); ++i)
+        table.push_back({ clips[i].first, clips[i].duration, static_cast<float>(std::max(clips[i].delay, 1U)), 0U });
+
+    if(m_clipTable.append(table.data(), table.size() * sizeof(ClipData)) == SIZE_MAX)
+    {
+        std::cerr << "Error: failed to upload " << table.size() << " animation clips\n";
+
+        return;
+    }
+
+    m_clips.insert(m_clips.end(), clips.begin() + static_cast<std::ptrdiff_t>(m_clips.size()), clips.end());
+    m_statistics.uploadedBytes += table.size() * sizeof(ClipData);
+}
+
+std::size_t SpriteEffects::spawn(unsigned texture, AnimationSystem::ClipId clip, const glm::mat4& matrix, double start, float rate, std::uint32_t flags, const Color& tint) noexcept
+{
+    if(!texture || clip >= m_clips.size() || m_clips[clip].duration == 0U)
+        return SIZE_MAX;
+
+    const auto index = static_cast<std::uint32_t>(m_effects.size());
+
+    Effect effect { glm::vec4(matrix[0].x, matrix[0].y, matrix[1].x, matrix[1].y), glm::vec2(matrix[3].x, matrix[3].y), 0.0f, rate, clip, flags, tint, 0U };
+
+    start        = rebaseStart(m_clips[clip], effect, start, m_epoch);
+    effect.start = static_cast<float>(start - m_epoch);
+
+    m_effects.push_back(effect);
+    m_starts.push_back(start);
+
+    if(m_runs.empty() || m_runs.back().texture != texture)
+        m_runs.push_back({ texture, index, 0U });
+
+    ++m_runs.back().count;
+
+    return index;
+}
+
+std::size_t SpriteEffects::spawn(unsigned texture, AnimationSystem::ClipId clip, const Transform2D& transform, double start, float rate, std::uint32_t flags, const Color& tint) noexcept
+{
+    return spawn(texture, clip, transform.getMatrix(), start, rate, flags, tint);
+}
+
+void SpriteEffects::clear() noexcept
+{
+    m_effects.clear();
+    m_starts.clear();
+    m_runs.clear();
+    m_effectBuffer.clear();
+    m_uploadedEffects    = 0U;
+    m_statistics.effects = 0U;
+}
+
+float SpriteEffects::setTime(double now) noexcept
+{
+    if(now - m_epoch >= RebaseInterval)
+        rebase(now);
+
+    return static_cast<float>(now - m_epoch);
+}
+
+void SpriteEffects::draw(const Shader* shader) noexcept
+{
+    m_statistics.drawCalls = 0U;
+
+    if(m_runs.empty() || !upload())
+        return;
+
+    glBindVertexArray(m_vao);
+    Shader::bind(shader);
+
+    for(const auto& run : m_runs)
+    {
+        glBindTexture(GL_TEXTURE_2D, run.texture);
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLE_FAN, 0, SpriteOutline::MaxVertices, static_cast<GLsizei>(run.count), run.first);
+
+        ++m_statistics.drawCalls;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    Shader::bind(nullptr);
+    glBindVertexArray(0);
+}
+
+void SpriteEffects::submit(const Shader* shader, RenderQueue& queue, std::uint8_t layer, std::uint16_t depth) noexcept
+{
+    m_statistics.drawCalls = 0U;
+
+    if(m_runs.empty() || !upload())
+        return;
+
+    for(const auto& run : m_runs)
+    {
+        DrawPacket packet;
+        packet.shader        = shader;
+        packet.texture       = run.texture;
+        packet.vao           = m_vao;
+        packet.mode          = GL_TRIANGLE_FAN;
+        packet.count         = SpriteOutline::MaxVertices;
+        packet.instanceCount = run.count;
+        packet.baseInstance  = run.first;
+
+        queue.submit(packet, layer, depth);
+
+        ++m_statistics.drawCalls;
+    }
+}
+
+std::uint32_t SpriteEffects::getFrame(std::size_t effect, double time) const noexcept
+{
+    if(effect >= m_effects.size())
+        return Animation::InvalidFrame;
+
+    return getFrame(m_clips[m_effects[effect].clip], m_effects[effect], static_cast<float>(time - m_epoch));
+}
+
+std::uint32_t SpriteEffects::getFrame(const Animation& clip, const Effect& effect, float time) noexcept
+{
+//  Same float arithmetic as effects.vert, rounded to whole milliseconds
+    const float elapsed  = std::floor((time - effect.start) * 1000.0f * effect.rate + 0.5f);
+    const bool  isLooped = (effect.flags & Looped) != 0U;
+
+    if(!isLooped && (effect.flags & Expires) && clip.getStepAt(elapsed) >= clip.duration)
+        return Animation::InvalidFrame;
+
+    return clip.getFrameAt(elapsed, isLooped, (effect.flags & Reversed) != 0U);
+}
+
+double SpriteEffects::rebaseStart(const Animation& clip, const Effect& effect, double start, double epoch) noexcept
+{
+    if(start >= epoch || effect.rate <= 0.0f)
+        return start;
+
+//  The clip in seconds at the playback rate
+    const double period = static_cast<double>(clip.duration) * std::max(clip.delay, 1U) / (1000.0 * effect.rate);
+
+    if(effect.flags & Looped)
+        return start + std::floor((epoch - start) / period) * period;
+
+//  A second of margin keeps it over after the rounding to whole milliseconds
+    return std::max(start, epoch - period - 1.0);
+}
+
+const SpriteEffects::Statistics& SpriteEffects::getStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+bool SpriteEffects::upload() noexcept
+{
+    if(!m_vao || m_clips.empty())
+        return false;
+
+//  Only the effects spawned since the last frame are sent, the others are already resident
+    if(m_uploadedEffects < m_effects.size())
+    {
+        const std::size_t count = m_effects.size() - m_uploadedEffects;
+
+        if(m_effectBuffer.append(m_effects.data() + m_uploadedEffects, count * sizeof(Effect)) == SIZE_MAX)
+        {
+            std::cerr << "Error: failed to upload " << count << " sprite effects\n";
+
+            return false;
+        }
+
+        m_uploadedEffects           = m_effects.size();
+        m_statistics.effects        = static_cast<std::uint32_t>(m_effects.size());
+        m_statistics.uploadedBytes += count * sizeof(Effect);
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ClipTableBinding, m_clipTable.getNativeHandle());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, EffectBinding, m_effectBuffer.getNativeHandle());
+
+    return true;
+}
+
+void SpriteEffects::rebase(double epoch) noexcept
+{
+    std::vector<Run> runs;
+    std::size_t      kept = 0U;
+
+//  Compacted in place, in spawn order, so the runs keep their textures and order
+    for(const auto& run : m_runs)
+        for(std::uint32_t i = run.first; i < run.first + run.count; ++i)
+        {
+            Effect           effect = m_effects[i];
+            const Animation& clip   = m_clips[effect.clip];
+            const double     start  = rebaseStart(clip, effect, m_starts[i], epoch);
+
+            effect.start = static_cast<float>(start - epoch);
+
+            if(getFrame(clip, effect, 0.0f) == Animation::InvalidFrame)
+                continue;
+
+            if(runs.empty() || runs.back().texture != run.texture)
+                runs.push_back({ run.texture, static_cast<std::uint32_t>(kept), 0U });
+
+            ++runs.back().count;
+
+            m_effects[kept] = effect;
+            m_starts[kept]  = start;
+            ++kept;
+        }
+
+    m_effects.resize(kept);
+    m_starts.resize(kept);
+    m_runs  = std::move(runs);
+    m_epoch = epoch;
+
+//  Every start changed: the whole buffer is written again by the next upload
+    m_effectBuffer.rewind();
+    m_uploadedEffects    = 0U;
+    m_statistics.effects = 0U;
+}
@@ -0,0 +1,134 @@
+#ifndef SPRITE_EFFECTS_HPP
+#define SPRITE_EFFECTS_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "system/NonCopyable.hpp"
+#include "graphics/Color.hpp"
+#include "graphics/GrowableBuffer.hpp"
+#include "controllers/AnimationSystem.hpp"
+
+// Ambient animated sprites that cost nothing on the CPU once spawned. An effect stores its placement, the
+// time it started, its clip and playback rate; effects.vert picks the frame from the Time of the FrameData
+// block and the clip table, with the same closed form as Animation::getFrameAt. The effects stay in a
+// storage buffer: spawning uploads them once, drawing is one instanced call per run of effects sharing a texture.
+// The clock is kept in double seconds; the GPU gets the times relative to an epoch that setTime moves forward
+// every RebaseInterval, so the float Time and starts never grow large enough to lose the milliseconds
+class SpriteEffects:
+    private NonCopyable
+{
+public:
+    static constexpr unsigned ClipTableBinding = 2; // Shader storage bindings, see animation.glsl
+    static constexpr unsigned EffectBinding    = 3; // and effects.vert
+
+    static constexpr double RebaseInterval = 64.0; // Seconds, below it a float time is exact to 8 us
+
+    enum Flags : std::uint32_t
+    {
+        Looped   = 1U << 0,
+        Reversed = 1U << 1,
+        Expires  = 1U << 2 // A clip that does not loop disappears once over instead of holding its last frame
+    };
+
+//  std430 layout of Clip in animation.glsl
+    struct ClipData
+    {
+        std::uint32_t first;
+        std::uint32_t duration;
+        float         delay; // Milliseconds, at least 1
+        std::uint32_t padding;
+    };
+
+//  std430 layout of Effect in effects.vert
+    struct Effect
+    {
+        glm::vec4     basis; // x axis in xy, y axis in zw
+        glm::vec2     origin;
+        float         start; // Seconds from the epoch of the clock
+        float         rate;
+        std::uint32_t clip;
+        std::uint32_t flags;
+        Color         tint;
+        std::uint32_t padding;
+    };
+
+    static_assert(sizeof(ClipData) == 16, "ClipData must match animation.glsl");
+    static_assert(sizeof(Effect) == 48, "Effect must match effects.vert");
+
+    struct Statistics
+    {
+        std::uint32_t effects       = 0U;
+        std::uint32_t drawCalls     = 0U; // Of the last draw or submit
+        std::uint64_t uploadedBytes = 0U;
+    };
+
+public:
+    SpriteEffects() noexcept;
+    ~SpriteEffects();
+
+    bool create() noexcept;
+
+//  Uploads the clips added to the library since the last call; effects can only use uploaded clips
+    void setClips(const AnimationSystem& system) noexcept;
+
+//  The texture is the one of the clip's frames, start is in seconds on the clock given to setTime.
+//  Returns the index of the effect, valid until the next rebase, or SIZE_MAX
+    std::size_t spawn(unsigned texture, AnimationSystem::ClipId clip, const glm::mat4& matrix, double start, float rate = 1.0f, std::uint32_t flags = Looped, const Color& tint = Color::White) noexcept;
+    std::size_t spawn(unsigned texture, AnimationSystem::ClipId clip, const class Transform2D& transform, double start, float rate = 1.0f, std::uint32_t flags = Looped, const Color& tint = Color::White) noexcept;
+
+    void clear() noexcept;
+
+//  Returns the Time to write into the FrameData block for now, in seconds. Once now is RebaseInterval past the
+//  epoch, the epoch moves to now: the Expires effects that are over are removed, the others are given the
+//  equivalent start closest to the new epoch and are uploaded again
+    float setTime(double now) noexcept;
+
+//  Uploads the effects spawned since the last call, binds the storage buffers and draws every effect.
+//  Leaves no program, texture or vertex array bound
+    void draw(const class Shader* shader) noexcept;
+
+//  Same, with one packet per run instead. The storage bindings are set here and have to stay until the queue executes
+    void submit(const class Shader* shader, class RenderQueue& queue, std::uint8_t layer, std::uint16_t depth = 0U) noexcept;
+
+//  What effects.vert draws for the effect at the given time, computed on the CPU.
+//  The member takes the time on the clock of setTime, the static one the Time of the FrameData block
+    std::uint32_t        getFrame(std::size_t effect, double time) const noexcept; // Into the frame arena, or Animation::InvalidFrame
+    static std::uint32_t getFrame(const Animation& clip, const Effect& effect, float time) noexcept;
+
+//  The start that plays the same frames from epoch on and is the closest to it: a looped effect is moved forward
+//  by whole periods of its clip, one that is over no further back than it takes to end
+    static double rebaseStart(const Animation& clip, const Effect& effect, double start, double epoch) noexcept;
+
+    const Statistics& getStatistics() const noexcept;
+
+private:
+    struct Run
+    {
+        unsigned      texture = 0U;
+        std::uint32_t first   = 0U;
+        std::uint32_t count   = 0U;
+    };
+
+    bool upload() noexcept;
+    void rebase(double epoch) noexcept;
+
+private:
+    std::vector<Effect>    m_effects;
+    std::vector<double>    m_starts; // Of m_effects, on the clock of setTime
+    std::vector<Run>       m_runs;
+    std::vector<Animation> m_clips; // Copy of the uploaded library, for getFrame
+
+    GrowableBuffer m_effectBuffer;
+    GrowableBuffer m_clipTable;
+    std::size_t    m_uploadedEffects;
+    double         m_epoch;
+    unsigned       m_vao; // No attributes, everything is read from the storage buffers
+
+    Statistics m_statistics;
+};
+
+#endif // !SPRITE_EFFECTS_HPP
@@ -0,0 +1,277 @@
+#include <glad/glad.h>
+
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+#include "graphics/Shader.hpp"
+#include "graphics/Transform2D.hpp"
+#include "graphics/RenderQueue.hpp"
+#include "graphics/SpriteInstancer.hpp"
+#include "managers/SpriteManager.hpp"
+
+SpriteInstancer::SpriteInstancer() noexcept:
+    m_shader(nullptr),
+    m_vao(0u),
+    m_vbo(0u),
+    m_capacity(0u),
+    m_cursor(0u),
+    m_isDrawing(false)
+{
+}
+
+SpriteInstancer::~SpriteInstancer()
+{
+    if(m_vao)
+        glDeleteVertexArrays(1, &m_vao);
+
+    if(m_vbo)
+        glDeleteBuffers(1, &m_vbo);
+}
+
+bool SpriteInstancer::create(std::size_t capacity) noexcept
+{
+    if(m_vao || capacity == 0U)
+        return false;
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+
+    glBindVertexArray(m_vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity * sizeof(Instance)), nullptr, GL_STREAM_DRAW);
+
+//  No per-vertex data: the corners come from the frame's outline through gl_VertexID, everything else advances once per instance
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, basis));
+    glEnableVertexAttribArray(0);
+    glVertexAttribDivisor(0, 1);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, origin));
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+
+    glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(Instance), (void*)offsetof(Instance, frame));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+
+    glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), (void*)offsetof(Instance, tint));
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_capacity = capacity;
+    m_cursor   = 0U;
+
+    return true;
+}
+
+void SpriteInstancer::CommandBuffer::draw(const Sprite2D& sprite, const Transform2D& transform, const Color& tint) noexcept
+{
+    draw(sprite, transform.getAffine(), tint);
+}
+
+void SpriteInstancer::CommandBuffer::draw(const Sprite2D& sprite, const glm::mat4& matrix, const Color& tint) noexcept
+{
+    draw(sprite, Affine2D::fromMatrix(matrix), tint);
+}
+
+void SpriteInstancer::CommandBuffer::draw(const Sprite2D& sprite, const Affine2D& affine, const Color& tint) noexcept
+{
+    if(!sprite.texture)
+        return;
+
+    m_instances.push_back({ glm::vec4(affine.axisX.x, affine.axisX.y, affine.axisY.x, affine.axisY.y), affine.translation, SpriteManager::getFrameIndex(sprite), tint });
+    m_textures.push_back(sprite.texture);
+}
+
+void SpriteInstancer::CommandBuffer::clear() noexcept
+{
+    m_instances.clear();
+    m_textures.clear();
+}
+
+std::size_t SpriteInstancer::CommandBuffer::getSpriteCount() const noexcept
+{
+    return m_instances.size();
+}
+
+void SpriteInstancer::begin(const Shader* shader) noexcept
+{
+    m_commands.clear();
+    m_frame     = Statistics();
+    m_shader    = shader;
+    m_isDrawing = true;
+}
+
+void SpriteInstancer::draw(const Sprite2D& sprite, const Transform2D& transform, const Color& tint) noexcept
+{
+    if(m_isDrawing)
+        m_commands.draw(sprite, transform.getAffine(), tint);
+}
+
+void SpriteInstancer::draw(const Sprite2D& sprite, const glm::mat4& matrix, const Color& tint) noexcept
+{
+    if(m_isDrawing)
+        m_commands.draw(sprite, Affine2D::fromMatrix(matrix), tint);
+}
+
+void SpriteInstancer::draw(const Sprite2D& sprite, const Affine2D& affine, const Color& tint) noexcept
+{
+    if(m_isDrawing)
+        m_commands.draw(sprite, affine, tint);
+}
+
+void SpriteInstancer::append(const CommandBuffer& commands) noexcept
+{
+    if(!m_isDrawing)
+        return;
+
+    m_commands.m_instances.insert(m_commands.m_instances.end(), commands.m_instances.begin(), commands.m_instances.end());
+    m_commands.m_textures.insert(m_commands.m_textures.end(), commands.m_textures.begin(), commands.m_textures.end());
+}
+
+void SpriteInstancer::end() noexcept
+{
+    flush(nullptr, 0U, 0U);
+}
+
+void SpriteInstancer::end(RenderQueue& queue, std::uint8_t layer, std::uint16_t depth) noexcept
+{
+    flush(&queue, layer, depth);
+}
+
+void SpriteInstancer::flush(RenderQueue* queue, std::uint8_t layer, std::uint16_t depth) noexcept
+{
+    if(!m_isDrawing)
+        return;
+
+    m_isDrawing = false;
+    m_groups.clear();
+
+//  Counting sort by texture: a frame uses few textures, so the groups are looked up linearly
+    m_groupOf.resize(m_commands.m_instances.size());
+
+    for(std::size_t i = 0; i < m_commands.m_instances.size(); ++i)
+    {
+        auto found = std::find_if(m_groups.begin(), m_groups.end(), [texture = m_commands.m_textures[i]](const Group& group) { return group.texture == texture; });
+
+        if(found == m_groups.end())
+            found = m_groups.insert(m_groups.end(), { m_commands.m_textures[i], 0U, 0U });
+
+        ++found->count;
+        m_groupOf[i] = static_cast<std::uint32_t>(found - m_groups.begin());
+    }
+
+    std::uint32_t first = 0U;
+
+    for(auto& group : m_groups)
+    {
+        group.first = first;
+        first      += group.count;
+        group.count = 0U;
+    }
+
+    m_sorted.resize(m_commands.m_instances.size());
+
+    for(std::size_t i = 0; i < m_commands.m_instances.size(); ++i)
+    {
+        auto& group = m_groups[m_groupOf[i]];
+        m_sorted[group.first + group.count++] = m_commands.m_instances[i];
+    }
+
+    if(!m_sorted.empty() && upload())
+    {
+        if(!queue)
+        {
+            glBindVertexArray(m_vao);
+            Shader::bind(m_shader);
+        }
+
+        for(const auto& group : m_groups)
+        {
+            if(queue)
+            {
+                DrawPacket packet;
+                packet.shader        = m_shader;
+                packet.texture       = group.texture;
+                packet.vao           = m_vao;
+                packet.mode          = GL_TRIANGLE_FAN;
+                packet.count         = SpriteOutline::MaxVertices;
+                packet.instanceCount = group.count;
+                packet.baseInstance  = static_cast<unsigned>(m_cursor + group.first);
+
+                queue->submit(packet, layer, depth);
+            }
+            else
+            {
+                glBindTexture(GL_TEXTURE_2D, group.texture);
+                glDrawArraysInstancedBaseInstance(GL_TRIANGLE_FAN, 0, SpriteOutline::MaxVertices, static_cast<GLsizei>(group.count), static_cast<GLuint>(m_cursor + group.first));
+            }
+
+            ++m_frame.drawCalls;
+        }
+
+        if(!queue)
+        {
+            glBindTexture(GL_TEXTURE_2D, 0);
+            Shader::bind(nullptr);
+            glBindVertexArray(0);
+        }
+
+        m_frame.sprites       = static_cast<std::uint32_t>(m_sorted.size());
+        m_frame.uploadedBytes = static_cast<std::uint32_t>(m_sorted.size() * sizeof(Instance));
+        m_cursor += m_sorted.size();
+    }
+
+    m_statistics = m_frame;
+}
+
+const SpriteInstancer::Statistics& SpriteInstancer::getStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+bool SpriteInstancer::upload() noexcept
+{
+    if(!m_vbo)
+        return false;
+
+    const std::size_t count = m_sorted.size();
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    if(count > m_capacity)
+    {
+        m_capacity = std::max(count, m_capacity * 2U);
+        m_cursor   = 0U;
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_capacity * sizeof(Instance)), nullptr, GL_STREAM_DRAW);
+    }
+    else if(m_cursor + count > m_capacity)
+    {
+//      Orphaning: the driver hands out fresh storage while the previous frames are still being read
+        m_cursor = 0U;
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_capacity * sizeof(Instance)), nullptr, GL_STREAM_DRAW);
+    }
+
+    const auto offset = static_cast<GLintptr>(m_cursor * sizeof(Instance));
+    const auto size   = static_cast<GLsizeiptr>(count * sizeof(Instance));
+
+    void* memory = glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+    if(!memory)
+    {
+        std::cerr << "Error: failed to map the sprite instance buffer\n";
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        return false;
+    }
+
+    std::memcpy(memory, m_sorted.data(), static_cast<std::size_t>(size));
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return true;
+}
@@ -0,0 +1,113 @@
+#ifndef SPRITE_INSTANCER_HPP
+#define SPRITE_INSTANCER_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "system/NonCopyable.hpp"
+#include "graphics/Color.hpp"
+#include "graphics/Affine2D.hpp"
+#include "graphics/Sprite2D.hpp"
+
+// Instanced sprite path: the meshes are generated from the frame table of SpriteManager by the INSTANCED
+// variant of batch.vert, so a sprite costs one 32-byte instance (2D affine, frame index, tint) instead of its vertices.
+// Every instance is a fan of SpriteOutline::MaxVertices corners; untrimmed frames repeat their last one.
+// Sprites are grouped by texture and every texture is drawn with a single instanced call; sprites keep
+// their submission order within a texture, textures are drawn in the order of their first sprite.
+class SpriteInstancer:
+    private NonCopyable
+{
+private:
+    struct Instance
+    {
+        glm::vec4     basis;  // x axis in xy, y axis in zw
+        glm::vec2     origin;
+        std::uint32_t frame;  // Index into the frame table
+        Color         tint;
+    };
+
+    static_assert(sizeof(Instance) == 32, "Instance must stay 32 bytes");
+
+public:
+    struct Statistics
+    {
+        std::uint32_t sprites       = 0U;
+        std::uint32_t drawCalls     = 0U;
+        std::uint32_t uploadedBytes = 0U;
+    };
+
+//  Recording context with no GL state: one per thread, filled in parallel and appended to the instancer on the GL thread
+    class CommandBuffer
+    {
+    public:
+        void draw(const Sprite2D& sprite, const class Transform2D& transform, const Color& tint = Color::White) noexcept;
+        void draw(const Sprite2D& sprite, const glm::mat4& matrix, const Color& tint = Color::White)            noexcept;
+        void draw(const Sprite2D& sprite, const Affine2D& affine, const Color& tint = Color::White)             noexcept;
+
+        void        clear()          noexcept;
+        std::size_t getSpriteCount() const noexcept;
+
+    private:
+        friend class SpriteInstancer;
+
+        std::vector<Instance> m_instances;
+        std::vector<unsigned> m_textures; // Texture of each instance
+    };
+
+public:
+    SpriteInstancer() noexcept;
+    ~SpriteInstancer();
+
+//  Capacity in instances; the buffer grows if a frame needs more
+    bool create(std::size_t capacity = 65536U) noexcept;
+
+    void begin(const class Shader* shader) noexcept;
+
+    void draw(const Sprite2D& sprite, const class Transform2D& transform, const Color& tint = Color::White) noexcept;
+    void draw(const Sprite2D& sprite, const glm::mat4& matrix, const Color& tint = Color::White)            noexcept;
+    void draw(const Sprite2D& sprite, const Affine2D& affine, const Color& tint = Color::White)             noexcept;
+
+//  Appends the sprites recorded by another thread after the ones already submitted
+    void append(const CommandBuffer& commands) noexcept;
+
+//  Uploads the instances and issues one draw per texture. Leaves no program, texture or vertex array bound
+    void end() noexcept;
+
+//  Uploads the instances and submits one packet per texture instead
+    void end(class RenderQueue& queue, std::uint8_t layer, std::uint16_t depth = 0U) noexcept;
+
+    const Statistics& getStatistics() const noexcept; // Of the last finished frame
+
+private:
+    struct Group
+    {
+        unsigned      texture = 0U;
+        std::uint32_t first   = 0U; // In the sorted instances
+        std::uint32_t count   = 0U;
+    };
+
+    void flush(class RenderQueue* queue, std::uint8_t layer, std::uint16_t depth) noexcept;
+    bool upload() noexcept;
+
+private:
+    CommandBuffer              m_commands;  // In submission order
+    std::vector<std::uint32_t> m_groupOf;   // Group of each instance
+    std::vector<Instance>      m_sorted;    // Grouped by texture
+    std::vector<Group>         m_groups;
+
+    const class Shader* m_shader;
+
+    unsigned    m_vao;
+    unsigned    m_vbo;
+    std::size_t m_capacity; // Instances the buffer holds
+    std::size_t m_cursor;   // First free instance since the last orphaning
+
+    Statistics m_frame;
+    Statistics m_statistics;
+    bool       m_isDrawing;
+};
+
+#endif // !SPRITE_INSTANCER_HPP
@@ -0,0 +1,226 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "graphics/Image.hpp"
+#include "graphics/SpriteOutline.hpp"
+
+namespace
+{
+    struct Point
+    {
+        double x;
+        double y;
+    };
+
+    double cross(const Point& origin, const Point& a, const Point& b) noexcept
+    {
+        return (a.x - origin.x) * (b.y - origin.y) - (a.y - origin.y) * (b.x - origin.x);
+    }
+
+//  Andrew's monotone chain. Collinear points are dropped, the hull runs counterclockwise in a y-up frame
+    std::vector<Point> makeConvexHull(std::vector<Point>& points) noexcept
+    {
+        std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+
+        std::vector<Point> hull(points.size() * 2U);
+        std::size_t count = 0U;
+
+        for(std::size_t i = 0; i < points.size(); ++i)
+        {
+            while(count >= 2U && cross(hull[count - 2U], hull[count - 1U], points[i]) <= 0.0)
+                --count;
+
+            hull[count++] = points[i];
+        }
+
+        for(std::size_t i = points.size() - 1U, lower = count + 1U; i-- > 0; )
+        {
+            while(count >= lower && cross(hull[count - 2U], hull[count - 1U], points[i]) <= 0.0)
+                --count;
+
+            hull[count++] = points[i];
+        }
+
+        hull.resize(count - 1U); // The last point is the first one again
+
+        return hull;
+    }
+
+//  Removes the edge whose neighbours, extended until they meet, add the least area. The new corner has
+//  to stay inside the frame, so the polygon never samples a neighbouring frame of the texture
+    bool removeCheapestEdge(std::vector<Point>& polygon, double width, double height) noexcept
+    {
+        const std::size_t count = polygon.size();
+        const double      eps   = 1e-9;
+
+        std::size_t best     = count;
+        double      bestArea = std::numeric_limits<double>::max();
+        Point       bestCorner { 0.0, 0.0 };
+
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const Point& a = polygon[(i + count - 1U) % count];
+            const Point& b = polygon[i];
+            const Point& c = polygon[(i + 1U) % count];
+            const Point& d = polygon[(i + 2U) % count];
+
+//          b + t * (b - a) meets c + s * (c - d) past both ends of the edge b c
+            const Point  u     { b.x - a.x, b.y - a.y };
+            const Point  w     { c.x - d.x, c.y - d.y };
+            const Point  bc    { c.x - b.x, c.y - b.y };
+            const double denom = u.x * w.y - u.y * w.x;
+
+            if(std::abs(denom) < eps)
+                continue; // Parallel neighbours never meet
+
+            const double t = (bc.x * w.y - bc.y * w.x) / denom;
+            const double s = (bc.x * u.y - bc.y * u.x) / denom;
+
+            if(t < 0.0 || s < 0.0)
+                continue;
+
+            const Point corner { b.x + t * u.x, b.y + t * u.y };
+
+            if(corner.x < -eps || corner.y < -eps || corner.x > width + eps || corner.y > height + eps)
+                continue;
+
+            const double area = std::abs(cross(b, c, corner)) * 0.5;
+
+            if(area < bestArea)
+            {
+                best       = i;
+                bestArea   = area;
+                bestCorner = corner;
+            }
+        }
+
+        if(best == count)
+            return false;
+
+        polygon[best] = bestCorner;
+        polygon.erase(polygon.begin() + static_cast<std::ptrdiff_t>((best + 1U) % count));
+
+        return true;
+    }
+}
+
+bool SpriteOutline::build(const Image& image, const glm::ivec4& frame, unsigned maxVertices, std::uint8_t threshold) noexcept
+{
+    const glm::uvec2& size = image.getSize();
+
+    if(frame.x < 0 || frame.y < 0 || frame.z <= 0 || frame.w <= 0 || frame.z > 65535 || frame.w > 65535 ||
+       static_cast<unsigned>(frame.x + frame.z) > size.x || static_cast<unsigned>(frame.y + frame.w) > size.y)
+        return false;
+
+    maxVertices = std::clamp(maxVertices, 3U, MaxVertices);
+
+//  The outer corners of the first and the last visible pixel of every row are enough for the hull
+    std::vector<Point> corners;
+    corners.reserve(static_cast<std::size_t>(frame.w) * 4U);
+
+    const unsigned char* pixels = image.getPixels();
+
+    for(int y = 0; y < frame.w; ++y)
+    {
+        const unsigned char* row = pixels + (static_cast<std::size_t>(frame.y + y) * size.x + static_cast<std::size_t>(frame.x)) * 4U;
+
+        int left = 0;
+
+        while(left < frame.z && row[left * 4 + 3] <= threshold)
+            ++left;
+
+        if(left == frame.z)
+            continue;
+
+        int right = frame.z - 1;
+
+        while(row[right * 4 + 3] <= threshold)
+            --right;
+
+        corners.push_back({ double(left),      double(y) });
+        corners.push_back({ double(left),      double(y + 1) });
+        corners.push_back({ double(right + 1), double(y) });
+        corners.push_back({ double(right + 1), double(y + 1) });
+    }
+
+    if(corners.empty())
+    {
+//      Nothing to draw: a degenerate quad keeps the frame addressable
+        std::fill(points, points + MaxVertices, glm::u16vec2(0, 0));
+        count = 4U;
+        area  = 0U;
+
+        return true;
+    }
+
+    const std::vector<Point> hull    = makeConvexHull(corners);
+    std::vector<Point>       polygon = hull;
+
+    while(polygon.size() > maxVertices)
+    {
+        if(!removeCheapestEdge(polygon, frame.z, frame.w))
+        {
+//          Stuck on nearly parallel edges: the bounding box of the visible pixels still trims the margins
+            auto [minX, maxX] = std::minmax_element(hull.begin(), hull.end(), [](const Point& a, const Point& b) { return a.x < b.x; });
+            auto [minY, maxY] = std::minmax_element(hull.begin(), hull.end(), [](const Point& a, const Point& b) { return a.y < b.y; });
+
+            polygon = { { minX->x, minY->y }, { maxX->x, minY->y }, { maxX->x, maxY->y }, { minX->x, maxY->y } };
+            break;
+        }
+    }
+
+//  The corners created by the reduction are not on the pixel grid: they are rounded away from the centre
+    Point centre { 0.0, 0.0 };
+
+    for(const auto& point : polygon)
+    {
+        centre.x += point.x / polygon.size();
+        centre.y += point.y / polygon.size();
+    }
+
+    const double eps = 1e-6;
+
+    for(std::size_t i = 0; i < polygon.size(); ++i)
+    {
+        const double x = polygon[i].x < centre.x ? std::floor(polygon[i].x + eps) : std::ceil(polygon[i].x - eps);
+        const double y = polygon[i].y < centre.y ? std::floor(polygon[i].y + eps) : std::ceil(polygon[i].y - eps);
+
+        points[i] = glm::u16vec2(static_cast<std::uint16_t>(std::clamp(x, 0.0, double(frame.z))), static_cast<std::uint16_t>(std::clamp(y, 0.0, double(frame.w))));
+    }
+
+    count = polygon.size() <= 4U ? 4U : MaxVertices;
+
+    std::fill(points + polygon.size(), points + MaxVertices, points[polygon.size() - 1U]);
+
+    double twiceArea = 0.0;
+
+    for(std::size_t i = 0; i < polygon.size(); ++i)
+    {
+        const auto& a = points[i];
+        const auto& b = points[(i + 1U) % polygon.size()];
+
+        twiceArea += double(a.x) * b.y - double(a.y) * b.x;
+    }
+
+    area = static_cast<std::uint64_t>(std::llround(std::abs(twiceArea) * 0.5));
+
+    return true;
+}
+
+void SpriteOutline::setQuad(unsigned width, unsigned height) noexcept
+{
+    const auto w = static_cast<std::uint16_t>(width);
+    const auto h = static_cast<std::uint16_t>(height);
+
+    points[0] = glm::u16vec2(0, 0);
+    points[1] = glm::u16vec2(w, 0);
+    points[2] = glm::u16vec2(w, h);
+    points[3] = glm::u16vec2(0, h);
+
+    std::fill(points + 4, points + MaxVertices, points[3]);
+
+    count = 4U;
+    area  = std::uint64_t(w) * h;
+}
@@ -0,0 +1,28 @@
+#ifndef SPRITE_OUTLINE_HPP
+#define SPRITE_OUTLINE_HPP
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// Convex polygon around the visible pixels of a sprite frame, drawn instead of the full quad
+// so the transparent margins of the frame cost no fill rate.
+// The points are in pixels from the top left corner of the frame and form a triangle fan. Polygons with
+// up to four corners are padded to four, bigger ones to MaxVertices, by repeating the last point:
+// the extra triangles are degenerate and every mesh of the same size shares one index pattern
+struct SpriteOutline
+{
+    static constexpr unsigned MaxVertices = 8U;
+
+//  Hull of the pixels with an alpha above threshold, reduced to maxVertices corners by growing it
+//  where that adds the least area. Returns false if the frame is outside the image
+    bool build(const class Image& image, const glm::ivec4& frame, unsigned maxVertices = MaxVertices, std::uint8_t threshold = 0U) noexcept;
+
+    void setQuad(unsigned width, unsigned height) noexcept;
+
+    glm::u16vec2  points[MaxVertices];
+    std::uint32_t count = 0U; // Vertices drawn: 4 or MaxVertices
+    std::uint64_t area  = 0U; // Covered pixels
+};
+
+#endif // !SPRITE_OUTLINE_HPP
@@ -6,7 +6,8 @@ Texture2D::Texture2D() noexcept:
     m_size(),
     m_texture(0u),
     m_isSmooth(false),
-    m_isRepeated(false)
+    m_isRepeated(false),
+    m_isResident(false)
 {
 }
 
@@ -23,21 +24,65 @@ bool Texture2D::loadFromFile(const std::string& filepath) noexcept
     return image.loadFromFile(filepath) && loadFromImage(image);
 }
 
+bool Texture2D::loadFromMemory(const void* data, std::size_t size) noexcept
+{
+    Image image;
+
+    return image.loadFromMemory(data, size) && loadFromImage(image);
+}
+
 bool Texture2D::loadFromImage(const Image& image) noexcept
 {
     if(image.getPixels() == nullptr)
         return false;
 
-    m_size = image.getSize();
+    return upload(image.getSize(), image.getPixels());
+}
+
+bool Texture2D::loadFromPixelBuffer(unsigned pbo, const glm::uvec2& size) noexcept
+{
+    if(!pbo)
+        return false;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    bool result = upload(size, nullptr); // Pixels are sourced from offset 0 of the bound buffer
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    return result;
+}
+
+bool Texture2D::createPlaceholder(const Color& color) noexcept
+{
+    const unsigned char pixel[] { color.r, color.g, color.b, color.a };
+
+    if(!upload(glm::uvec2(1, 1), pixel))
+        return false;
+
+    m_size       = glm::uvec2(0, 0);
+    m_isResident = false;
+
+    return true;
+}
+
+bool Texture2D::upload(const glm::uvec2& size, const void* pixels) noexcept
+{
+    if(size.x == 0 || size.y == 0)
+        return false;
+
+    m_size = size;
     const int width  = static_cast<int>(m_size.x);
     const int height = static_cast<int>(m_size.y);
 
-	glGenTextures(1, &m_texture);
+    if(!m_texture)
+	    glGenTextures(1, &m_texture);
+
     Texture2D::bind(this);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.getPixels());
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 	glGenerateMipmap(GL_TEXTURE_2D);
     Texture2D::bind(nullptr);
 
+    m_isResident = true;
+
     return true;
 }
 
@@ -99,6 +144,11 @@ bool Texture2D::isRepeated() const noexcept
     return m_isRepeated;
 }
 
+bool Texture2D::isResident() const noexcept
+{
+    return m_isResident;
+}
+
 unsigned Texture2D::getNativeHandle() const noexcept
 {
     return m_texture;
@@ -11,26 +11,38 @@ public:
 	Texture2D() noexcept;
 	~Texture2D();
 
-	bool loadFromFile(const std::string& filepath) noexcept;
-	bool loadFromImage(const Image& image)         noexcept;
+	bool loadFromFile(const std::string& filepath)          noexcept;
+	bool loadFromMemory(const void* data, std::size_t size) noexcept;
+	bool loadFromImage(const Image& image)                  noexcept;
+
+//	Uploads size.x * size.y RGBA pixels from the start of a pixel unpack buffer
+	bool loadFromPixelBuffer(unsigned pbo, const glm::uvec2& size) noexcept;
+
+//	1x1 texture that stands in until the real pixels are uploaded; the handle stays the same
+	bool createPlaceholder(const Color& color) noexcept;
 
 	void setSmooth(bool smooth)    noexcept;
 	void setRepeated(bool repeate) noexcept;
 
 	bool isSmooth()   const noexcept;
 	bool isRepeated() const noexcept;
+	bool isResident() const noexcept;
 
 	unsigned getNativeHandle()    const noexcept;
 	const glm::uvec2& getSize() const noexcept;
 
 	static void bind(const Texture2D* texture) noexcept;
 
+private:
+	bool upload(const glm::uvec2& size, const void* pixels) noexcept;
+
 private:
 	glm::uvec2 m_size;
 	unsigned   m_texture;
 
 	bool m_isSmooth;
 	bool m_isRepeated;
+	bool m_isResident;
 };
 
 #endif // !TEXTURE2D_HPP
\ No newline at end of file
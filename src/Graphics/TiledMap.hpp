@@ -3,20 +3,58 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 #include <glm/glm.hpp>
 
+#include "system/StringId.hpp"
+#include "managers/AssetHandle.hpp"
+
 struct TiledMap
 {
+	static constexpr unsigned ChunkSize = 32U; // Tiles per side of a layer chunk
+
+//	The tile shaders read the tile size from the base instance of the draw (tile_size.glsl),
+//	so one program draws maps of any tile size. Both sides must fit in 16 bits
+	static std::uint32_t packTileSize(const glm::uvec2& size) noexcept
+	{
+		return (size.x & 0xFFFFU) | (size.y & 0xFFFFU) << 16;
+	}
+
+//	A square of ChunkSize tiles: its quads are contiguous in the vertex buffer of the layer
+	struct Chunk
+	{
+		glm::vec4 bounds { 0.0f }; // Of its tiles, in pixels: left, top, right, bottom
+		unsigned  first = 0U;      // First quad
+		unsigned  count = 0U;      // Quads, 0 for an empty chunk
+	};
+
 	struct Layer
 	{
 		std::string name;
 
 		unsigned texture = 0U; // Texture handle
-		unsigned count   = 0U; // Number of indices to render
+		unsigned count   = 0U; // Number of indices to render, from the shared quad index buffer
 		unsigned vao     = 0U; // Vertex array object
-		unsigned vbo     = 0U; // Vertex buffer object
-		unsigned ebo     = 0U; // Element buffer object
+		unsigned vbo     = 0U; // Vertex buffer object, PackedVertex2D in tile units
+
+		glm::uvec2 tileSize { 0U }; // In pixels
+
+//		The same tiles for tilemap_indices.frag: one texel per tile, 0 when empty, else 1 + the tile in the tileset
+		unsigned indexTexture = 0U; // GL_R16UI, GL_R32UI for tilesets of 65535 tiles or more
+
+		std::vector<Chunk> chunks;               // Row by row, empty ones included
+		unsigned           chunkColumns = 0U;
+		unsigned           chunkRows    = 0U;
+		unsigned           filledChunks = 0U;    // With at least one tile
+		glm::vec2          chunkExtent { 0.0f }; // Of a whole chunk, in pixels
+	};
+
+	struct MemoryStatistics
+	{
+		std::size_t vertexBytes = 0U; // Tile vertices on the GPU
+		std::size_t savedBytes  = 0U; // Against float vertices with 32-bit indices
+		std::size_t indexBytes  = 0U; // Tile index textures
 	};
 
 	struct Object
@@ -39,9 +77,11 @@ struct TiledMap
 
     std::vector<Layer>  m_layers;
     std::vector<Object> m_objects;
-    std::string         m_name;
+    std::vector<AssetHandle<class Texture2D>> m_tilesets;
+    StringId            m_name;
     glm::uvec2          m_mapSize;
     glm::uvec2          m_tileSize;
+    MemoryStatistics    m_memory;
 };
 
 #endif // !TILED_MAP_HPP
\ No newline at end of file
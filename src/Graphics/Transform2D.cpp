@@ -149,3 +149,8 @@ const glm::mat4& Transform2D::getMatrix() const noexcept
 
     return m_matrix;
 }
+
+Affine2D Transform2D::getAffine() const noexcept
+{
+    return Affine2D::fromMatrix(getMatrix());
+}
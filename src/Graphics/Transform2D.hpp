@@ -4,6 +4,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "graphics/Affine2D.hpp"
+
 class Transform2D
 {
 public:
@@ -35,6 +37,7 @@ public:
     Transform2D* scale(const glm::vec2& factor)      noexcept;
 
     const glm::mat4& getMatrix() const noexcept;
+    Affine2D         getAffine() const noexcept;
 
 private:
     mutable glm::mat4 m_matrix;
@@ -0,0 +1,488 @@
+#include <cmath>
+#include <algorithm>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define TRANSFORM_SYSTEM_SSE2
+#endif
+
+#include "system/ThreadPool.hpp"
+#include "graphics/TransformSystem.hpp"
+
+namespace
+{
+//  The same kernel is written once against these lane types: Width transforms per operation
+    struct ScalarLanes
+    {
+        using Float = float;
+        using Int   = std::int32_t;
+
+        static constexpr unsigned    Width = 1U;
+        static constexpr const char* Name  = "Scalar";
+
+        static Float load(const float* source) noexcept      { return *source; }
+        static void  store(float* target, Float a) noexcept  { *target = a; }
+        static Float set(float a) noexcept                   { return a; }
+        static Float add(Float a, Float b) noexcept          { return a + b; }
+        static Float sub(Float a, Float b) noexcept          { return a - b; }
+        static Float mul(Float a, Float b) noexcept          { return a * b; }
+        static Int   round(Float a) noexcept                 { return static_cast<Int>(std::nearbyint(a)); }
+        static Int   addInt(Int a, std::int32_t b) noexcept  { return a + b; }
+        static Float toFloat(Int a) noexcept                 { return static_cast<Float>(a); }
+
+//      (bits & bit) ? a : b, and the same to flip a sign
+        static Float select(Int bits, std::int32_t bit, Float a, Float b) noexcept { return (bits & bit) ? a : b; }
+        static Float negateIf(Int bits, std::int32_t bit, Float a) noexcept       { return (bits & bit) ? -a : a; }
+    };
+
+#if defined(__AVX2__)
+    struct SimdLanes
+    {
+        using Float = __m256;
+        using Int   = __m256i;
+
+        static constexpr unsigned    Width = 8U;
+        static constexpr const char* Name  = "AVX2";
+
+        static Float load(const float* source) noexcept      { return _mm256_loadu_ps(source); }
+        static void  store(float* target, Float a) noexcept  { _mm256_store_ps(target, a); }
+        static Float set(float a) noexcept                   { return _mm256_set1_ps(a); }
+        static Float add(Float a, Float b) noexcept          { return _mm256_add_ps(a, b); }
+        static Float sub(Float a, Float b) noexcept          { return _mm256_sub_ps(a, b); }
+        static Float mul(Float a, Float b) noexcept          { return _mm256_mul_ps(a, b); }
+        static Int   round(Float a) noexcept                 { return _mm256_cvtps_epi32(a); }
+        static Int   addInt(Int a, std::int32_t b) noexcept  { return _mm256_add_epi32(a, _mm256_set1_epi32(b)); }
+        static Float toFloat(Int a) noexcept                 { return _mm256_cvtepi32_ps(a); }
+
+        static Float getMask(Int bits, std::int32_t bit) noexcept
+        {
+            const __m256i value = _mm256_set1_epi32(bit);
+
+            return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(bits, value), value));
+        }
+
+        static Float select(Int bits, std::int32_t bit, Float a, Float b) noexcept { return _mm256_blendv_ps(b, a, getMask(bits, bit)); }
+        static Float negateIf(Int bits, std::int32_t bit, Float a) noexcept
+        {
+            return _mm256_xor_ps(a, _mm256_and_ps(getMask(bits, bit), _mm256_castsi256_ps(_mm256_set1_epi32(INT32_MIN))));
+        }
+    };
+#elif defined(TRANSFORM_SYSTEM_SSE2)
+    struct SimdLanes
+    {
+        using Float = __m128;
+        using Int   = __m128i;
+
+        static constexpr unsigned    Width = 4U;
+        static constexpr const char* Name  = "SSE2";
+
+        static Float load(const float* source) noexcept      { return _mm_loadu_ps(source); }
+        static void  store(float* target, Float a) noexcept  { _mm_store_ps(target, a); }
+        static Float set(float a) noexcept                   { return _mm_set1_ps(a); }
+        static Float add(Float a, Float b) noexcept          { return _mm_add_ps(a, b); }
+        static Float sub(Float a, Float b) noexcept          { return _mm_sub_ps(a, b); }
+        static Float mul(Float a, Float b) noexcept          { return _mm_mul_ps(a, b); }
+        static Int   round(Float a) noexcept                 { return _mm_cvtps_epi32(a); }
+        static Int   addInt(Int a, std::int32_t b) noexcept  { return _mm_add_epi32(a, _mm_set1_epi32(b)); }
+        static Float toFloat(Int a) noexcept                 { return _mm_cvtepi32_ps(a); }
+
+        static Float getMask(Int bits, std::int32_t bit) noexcept
+        {
+            const __m128i value = _mm_set1_epi32(bit);
+
+            return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(bits, value), value));
+        }
+
+//      No blend before SSE4.1
+        static Float select(Int bits, std::int32_t bit, Float a, Float b) noexcept
+        {
+            const __m128 mask = getMask(bits, bit);
+
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+
+        static Float negateIf(Int bits, std::int32_t bit, Float a) noexcept
+        {
+            return _mm_xor_ps(a, _mm_and_ps(getMask(bits, bit), _mm_castsi128_ps(_mm_set1_epi32(INT32_MIN))));
+        }
+    };
+#else
+    using SimdLanes = ScalarLanes;
+#endif
+
+    struct Source
+    {
+        const float* positionsX;
+        const float* positionsY;
+        const float* rotations;
+        const float* scalesX;
+        const float* scalesY;
+        const float* originsX;
+        const float* originsY;
+    };
+
+//  Transform2D::getMatrix for BlockSize transforms from the given entry. The angle is negated and brought
+//  to [-45, 45] degrees around a multiple of 90, which is exact in degrees; the minimax polynomials of
+//  the Cephes sinf and cosf take the rest, and the quadrant swaps or negates the results
+    template <typename Lanes>
+    void computeBlock(const Source& source, std::size_t entry, std::size_t count, Affine2D* affines) noexcept
+    {
+        using Float = typename Lanes::Float;
+        using Int   = typename Lanes::Int;
+
+        alignas(32) float results[6][TransformSystem::BlockSize];
+
+        for(std::size_t lane = 0; lane < TransformSystem::BlockSize; lane += Lanes::Width)
+        {
+            const std::size_t i = entry + lane;
+
+            const Float angle   = Lanes::mul(Lanes::load(source.rotations + i), Lanes::set(-1.0f));
+            const Int   quarter = Lanes::round(Lanes::mul(angle, Lanes::set(1.0f / 90.0f)));
+            const Float x       = Lanes::mul(Lanes::sub(angle, Lanes::mul(Lanes::toFloat(quarter), Lanes::set(90.0f))), Lanes::set(0.017453292519943295f));
+            const Float x2      = Lanes::mul(x, x);
+
+            Float sine = Lanes::add(Lanes::mul(x2, Lanes::set(-1.9515295891e-4f)), Lanes::set(8.3321608736e-3f));
+            sine = Lanes::add(Lanes::mul(sine, x2), Lanes::set(-1.6666654611e-1f));
+            sine = Lanes::add(Lanes::mul(Lanes::mul(sine, x2), x), x);
+
+            Float cosine = Lanes::add(Lanes::mul(x2, Lanes::set(2.443315711809948e-5f)), Lanes::set(-1.388731625493765e-3f));
+            cosine = Lanes::add(Lanes::mul(cosine, x2), Lanes::set(4.166664568298827e-2f));
+            cosine = Lanes::add(Lanes::sub(Lanes::mul(Lanes::mul(cosine, x2), x2), Lanes::mul(x2, Lanes::set(0.5f))), Lanes::set(1.0f));
+
+            const Float sin = Lanes::negateIf(quarter, 2, Lanes::select(quarter, 1, cosine, sine));
+            const Float cos = Lanes::negateIf(Lanes::addInt(quarter, 1), 2, Lanes::select(quarter, 1, sine, cosine));
+
+            const Float scaleX = Lanes::load(source.scalesX + i);
+            const Float scaleY = Lanes::load(source.scalesY + i);
+            const Float originX = Lanes::load(source.originsX + i);
+            const Float originY = Lanes::load(source.originsY + i);
+
+            const Float sxc = Lanes::mul(scaleX, cos);
+            const Float syc = Lanes::mul(scaleY, cos);
+            const Float sxs = Lanes::mul(scaleX, sin);
+            const Float sys = Lanes::mul(scaleY, sin);
+
+            Lanes::store(results[0] + lane, sxc);
+            Lanes::store(results[1] + lane, Lanes::mul(sxs, Lanes::set(-1.0f)));
+            Lanes::store(results[2] + lane, sys);
+            Lanes::store(results[3] + lane, syc);
+            Lanes::store(results[4] + lane, Lanes::sub(Lanes::load(source.positionsX + i), Lanes::add(Lanes::mul(originX, sxc), Lanes::mul(originY, sys))));
+            Lanes::store(results[5] + lane, Lanes::add(Lanes::load(source.positionsY + i), Lanes::sub(Lanes::mul(originX, sxs), Lanes::mul(originY, syc))));
+        }
+
+        const std::size_t lanes = std::min<std::size_t>(TransformSystem::BlockSize, count - entry);
+
+        for(std::size_t lane = 0; lane < lanes; ++lane)
+        {
+            Affine2D& affine = affines[entry + lane];
+            affine.axisX       = glm::vec2(results[0][lane], results[1][lane]);
+            affine.axisY       = glm::vec2(results[2][lane], results[3][lane]);
+            affine.translation = glm::vec2(results[4][lane], results[5][lane]);
+        }
+    }
+
+    const Affine2D Identity;
+}
+
+TransformSystem::TransformSystem() noexcept
+{
+}
+
+TransformSystem::Transform TransformSystem::create() noexcept
+{
+    Transform transform;
+
+    if(!m_freeTransforms.empty())
+    {
+        transform = m_freeTransforms.back();
+        m_freeTransforms.pop_back();
+    }
+    else
+    {
+        transform = static_cast<Transform>(m_slots.size());
+        m_slots.push_back(Invalid);
+    }
+
+    const auto slot = static_cast<std::uint32_t>(m_columns.getSize());
+
+    m_slots[transform] = slot;
+    m_columns.push(transform);
+
+    if(m_dirtyBlocks.size() * BlockSize < m_columns.getSize())
+        m_dirtyBlocks.push_back(0U);
+
+    invalidate(slot);
+    m_statistics.transforms = static_cast<std::uint32_t>(m_columns.getSize());
+
+    return transform;
+}
+
+void TransformSystem::destroy(Transform transform) noexcept
+{
+    const std::uint32_t slot = getSlot(transform);
+
+    if(slot == Invalid)
+        return;
+
+//  The last entry fills the hole, so the arrays stay packed
+    const std::size_t last = m_columns.getSize() - 1U;
+
+    if(slot != last)
+    {
+        m_columns.moveTo(last, slot);
+        m_slots[m_columns.owners[slot]] = slot;
+
+//      Its affine may not be up to date yet, and the old block no longer recomputes it
+        invalidate(slot);
+    }
+
+    m_columns.pop();
+    m_slots[transform] = Invalid;
+    m_freeTransforms.push_back(transform);
+
+    m_dirtyBlocks.resize((m_columns.getSize() + BlockSize - 1U) / BlockSize);
+    m_statistics.transforms = static_cast<std::uint32_t>(m_columns.getSize());
+}
+
+void TransformSystem::setPosition(Transform transform, float x, float y) noexcept
+{
+    if(const std::uint32_t slot = getSlot(transform); slot != Invalid)
+    {
+        m_columns.positionsX[slot] = x;
+        m_columns.positionsY[slot] = y;
+        invalidate(slot);
+    }
+}
+
+void TransformSystem::setRotation(Transform transform, float angle) noexcept
+{
+    if(const std::uint32_t slot = getSlot(transform); slot != Invalid)
+    {
+        float rotation = std::fmod(angle, 360.0f);
+
+        if(rotation < 0.0f)
+            rotation += 360.0f;
+
+        m_columns.rotations[slot] = rotation;
+        invalidate(slot);
+    }
+}
+
+void TransformSystem::setScale(Transform transform, float factorX, float factorY) noexcept
+{
+    if(const std::uint32_t slot = getSlot(transform); slot != Invalid)
+    {
+        m_columns.scalesX[slot] = factorX;
+        m_columns.scalesY[slot] = factorY;
+        invalidate(slot);
+    }
+}
+
+void TransformSystem::setOrigin(Transform transform, float x, float y) noexcept
+{
+    if(const std::uint32_t slot = getSlot(transform); slot != Invalid)
+    {
+        m_columns.originsX[slot] = x;
+        m_columns.originsY[slot] = y;
+        invalidate(slot);
+    }
+}
+
+void TransformSystem::move(Transform transform, float offsetX, float offsetY) noexcept
+{
+    const glm::vec2 position = getPosition(transform);
+
+    setPosition(transform, position.x + offsetX, position.y + offsetY);
+}
+
+void TransformSystem::rotate(Transform transform, float angle) noexcept
+{
+    setRotation(transform, getRotation(transform) + angle);
+}
+
+glm::vec2 TransformSystem::getPosition(Transform transform) const noexcept
+{
+    const std::uint32_t slot = getSlot(transform);
+
+    return (slot != Invalid) ? glm::vec2(m_columns.positionsX[slot], m_columns.positionsY[slot]) : glm::vec2(0.0f, 0.0f);
+}
+
+float TransformSystem::getRotation(Transform transform) const noexcept
+{
+    const std::uint32_t slot = getSlot(transform);
+
+    return (slot != Invalid) ? m_columns.rotations[slot] : 0.0f;
+}
+
+glm::vec2 TransformSystem::getScale(Transform transform) const noexcept
+{
+    const std::uint32_t slot = getSlot(transform);
+
+    return (slot != Invalid) ? glm::vec2(m_columns.scalesX[slot], m_columns.scalesY[slot]) : glm::vec2(1.0f, 1.0f);
+}
+
+glm::vec2 TransformSystem::getOrigin(Transform transform) const noexcept
+{
+    const std::uint32_t slot = getSlot(transform);
+
+    return (slot != Invalid) ? glm::vec2(m_columns.originsX[slot], m_columns.originsY[slot]) : glm::vec2(0.0f, 0.0f);
+}
+
+void TransformSystem::update() noexcept
+{
+    m_statistics.updated = updateBlocks(0U, m_dirtyBlocks.size());
+}
+
+void TransformSystem::update(ThreadPool& pool) noexcept
+{
+    const std::size_t          blocks = m_dirtyBlocks.size();
+    std::vector<std::uint32_t> updated(pool.getChunkCount(blocks), 0U);
+
+//  Blocks never share an affine, so the ranges are independent
+    pool.parallelFor(blocks, [&](std::size_t chunk, std::size_t begin, std::size_t end)
+    {
+        updated[chunk] = updateBlocks(begin, end);
+    });
+
+    m_statistics.updated = 0U;
+
+    for(const auto count : updated)
+        m_statistics.updated += count;
+}
+
+const Affine2D& TransformSystem::getAffine(Transform transform) const noexcept
+{
+    const std::uint32_t slot = getSlot(transform);
+
+    return (slot != Invalid) ? m_columns.affines[slot] : Identity;
+}
+
+const std::vector<Affine2D>& TransformSystem::getAffines() const noexcept
+{
+    return m_columns.affines;
+}
+
+TransformSystem::Transform TransformSystem::getTransformAt(std::size_t entry) const noexcept
+{
+    return (entry < m_columns.getSize()) ? m_columns.owners[entry] : Invalid;
+}
+
+const char* TransformSystem::getInstructionSet() noexcept
+{
+    return SimdLanes::Name;
+}
+
+std::size_t TransformSystem::getTransformCount() const noexcept
+{
+    return m_columns.getSize();
+}
+
+const TransformSystem::Statistics& TransformSystem::getStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+std::uint32_t TransformSystem::getSlot(Transform transform) const noexcept
+{
+    return (transform < m_slots.size()) ? m_slots[transform] : Invalid;
+}
+
+void TransformSystem::invalidate(std::uint32_t slot) noexcept
+{
+    m_dirtyBlocks[slot / BlockSize] = 1U;
+}
+
+std::uint32_t TransformSystem::updateBlocks(std::size_t first, std::size_t last) noexcept
+{
+    const Source source =
+    {
+        m_columns.positionsX.data(), m_columns.positionsY.data(), m_columns.rotations.data(),
+        m_columns.scalesX.data(), m_columns.scalesY.data(), m_columns.originsX.data(), m_columns.originsY.data()
+    };
+
+    const std::size_t count   = m_columns.getSize();
+    std::uint32_t     updated = 0U;
+
+    for(std::size_t block = first; block < last; ++block)
+    {
+        if(!m_dirtyBlocks[block])
+            continue;
+
+        computeBlock<SimdLanes>(source, block * BlockSize, count, m_columns.affines.data());
+
+        m_dirtyBlocks[block] = 0U;
+        updated += static_cast<std::uint32_t>(std::min<std::size_t>(BlockSize, count - block * BlockSize));
+    }
+
+    return updated;
+}
+
+std::size_t TransformSystem::Columns::getSize() const noexcept
+{
+    return owners.size();
+}
+
+void TransformSystem::Columns::push(Transform transform) noexcept
+{
+//  A new block of identity transforms whenever the last one is full
+    if(owners.size() % BlockSize == 0U)
+    {
+        const std::size_t size = owners.size() + BlockSize;
+
+        positionsX.resize(size, 0.0f);
+        positionsY.resize(size, 0.0f);
+        rotations.resize(size, 0.0f);
+        scalesX.resize(size, 1.0f);
+        scalesY.resize(size, 1.0f);
+        originsX.resize(size, 0.0f);
+        originsY.resize(size, 0.0f);
+    }
+
+    affines.emplace_back();
+    owners.push_back(transform);
+}
+
+void TransformSystem::Columns::moveTo(std::size_t from, std::size_t to) noexcept
+{
+    positionsX[to] = positionsX[from];
+    positionsY[to] = positionsY[from];
+    rotations[to]  = rotations[from];
+    scalesX[to]    = scalesX[from];
+    scalesY[to]    = scalesY[from];
+    originsX[to]   = originsX[from];
+    originsY[to]   = originsY[from];
+    affines[to]    = affines[from];
+    owners[to]     = owners[from];
+}
+
+void TransformSystem::Columns::pop() noexcept
+{
+    const std::size_t last = owners.size() - 1U;
+
+    affines.pop_back();
+    owners.pop_back();
+
+//  The padding goes back to the identity, and whole free blocks are released
+    if(last % BlockSize == 0U)
+    {
+        positionsX.resize(last);
+        positionsY.resize(last);
+        rotations.resize(last);
+        scalesX.resize(last);
+        scalesY.resize(last);
+        originsX.resize(last);
+        originsY.resize(last);
+
+        return;
+    }
+
+    positionsX[last] = 0.0f;
+    positionsY[last] = 0.0f;
+    rotations[last]  = 0.0f;
+    scalesX[last]    = 1.0f;
+    scalesY[last]    = 1.0f;
+    originsX[last]   = 0.0f;
+    originsY[last]   = 0.0f;
+}
@@ -0,0 +1,101 @@
+#ifndef TRANSFORM_SYSTEM_HPP
+#define TRANSFORM_SYSTEM_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "system/NonCopyable.hpp"
+#include "graphics/Affine2D.hpp"
+
+// Transform2D for many objects at once. Position, rotation, scale and origin are kept as parallel arrays
+// packed without holes, and update() recomputes the affines of the blocks of BlockSize transforms that
+// changed, several transforms per instruction: AVX2 when the compiler targets it, SSE2 otherwise on x86,
+// plain scalar code elsewhere. The affines are laid out for SpriteBatch and SpriteInstancer to draw from
+class TransformSystem:
+    private NonCopyable
+{
+public:
+    using Transform = std::uint32_t;
+
+    static constexpr std::uint32_t Invalid   = UINT32_MAX;
+    static constexpr unsigned      BlockSize = 8U; // Transforms recomputed together, one AVX2 register
+
+    struct Statistics
+    {
+        std::uint32_t transforms = 0U;
+        std::uint32_t updated    = 0U; // Affines recomputed by the last update, whole blocks
+    };
+
+public:
+    TransformSystem() noexcept;
+
+    Transform create() noexcept;
+    void      destroy(Transform transform) noexcept;
+
+//  Same conventions as Transform2D: the rotation is in degrees, the origin in local units
+    void setPosition(Transform transform, float x, float y) noexcept;
+    void setRotation(Transform transform, float angle) noexcept;
+    void setScale(Transform transform, float factorX, float factorY) noexcept;
+    void setOrigin(Transform transform, float x, float y) noexcept;
+
+    void move(Transform transform, float offsetX, float offsetY) noexcept;
+    void rotate(Transform transform, float angle) noexcept;
+
+    glm::vec2 getPosition(Transform transform) const noexcept;
+    float     getRotation(Transform transform) const noexcept;
+    glm::vec2 getScale(Transform transform)    const noexcept;
+    glm::vec2 getOrigin(Transform transform)   const noexcept;
+
+//  Recomputes the affines changed since the last update, on the pool's threads for the second one
+    void update() noexcept;
+    void update(class ThreadPool& pool) noexcept;
+
+    const Affine2D& getAffine(Transform transform) const noexcept; // As of the last update
+
+//  Every affine in packed order, getTransformAt gives the transform of an entry
+    const std::vector<Affine2D>& getAffines() const noexcept;
+    Transform                    getTransformAt(std::size_t entry) const noexcept;
+
+    static const char* getInstructionSet() noexcept;
+
+    std::size_t       getTransformCount() const noexcept;
+    const Statistics& getStatistics()     const noexcept;
+
+private:
+//  One entry per live transform. The input columns are padded to a multiple of BlockSize with the identity,
+//  so the update loads whole blocks without a scalar tail
+    struct Columns
+    {
+        std::vector<float>     positionsX;
+        std::vector<float>     positionsY;
+        std::vector<float>     rotations;
+        std::vector<float>     scalesX;
+        std::vector<float>     scalesY;
+        std::vector<float>     originsX;
+        std::vector<float>     originsY;
+        std::vector<Affine2D>  affines;
+        std::vector<Transform> owners; // Transform of each entry
+
+        std::size_t getSize() const noexcept;
+        void        push(Transform transform) noexcept;
+        void        moveTo(std::size_t from, std::size_t to) noexcept;
+        void        pop() noexcept;
+    };
+
+    std::uint32_t getSlot(Transform transform) const noexcept; // Invalid if the transform does not exist
+    void          invalidate(std::uint32_t slot) noexcept;
+    std::uint32_t updateBlocks(std::size_t first, std::size_t last) noexcept;
+
+private:
+    Columns                    m_columns;
+    std::vector<std::uint8_t>  m_dirtyBlocks;
+    std::vector<std::uint32_t> m_slots;          // Entry of each transform in m_columns, Invalid once destroyed
+    std::vector<Transform>     m_freeTransforms;
+
+    Statistics m_statistics;
+};
+
+#endif // !TRANSFORM_SYSTEM_HPP
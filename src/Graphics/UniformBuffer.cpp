@@ -0,0 +1,68 @@
+#include <glad/glad.h>
+
+#include <iostream>
+#include <cstring>
+
+#include "graphics/UniformBuffer.hpp"
+
+UniformBuffer::UniformBuffer() noexcept:
+    m_buffer(0u),
+    m_binding(0u)
+{
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    if(m_buffer)
+        glDeleteBuffers(1, &m_buffer);
+}
+
+bool UniformBuffer::create(std::size_t size, unsigned binding) noexcept
+{
+    if(m_buffer || size == 0U)
+        return false;
+
+    int maxBindings = 0;
+    glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindings);
+
+    if(binding >= static_cast<unsigned>(maxBindings))
+    {
+        std::cerr << "Error: uniform buffer binding " << binding << " is out of range\n";
+
+        return false;
+    }
+
+    m_shadow.assign(size, 0); // Zeroed on the GPU too, so the shadow copy is exact from the start
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), m_shadow.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_buffer);
+
+    m_binding = binding;
+
+    return true;
+}
+
+bool UniformBuffer::update(const void* data, std::size_t size, std::size_t offset) noexcept
+{
+    if(!m_buffer || offset + size > m_shadow.size())
+        return false;
+
+    if(std::memcmp(m_shadow.data() + offset, data, size) == 0)
+        return true;
+
+    std::memcpy(m_shadow.data() + offset, data, size);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    return true;
+}
+
+unsigned UniformBuffer::getBinding() const noexcept
+{
+    return m_binding;
+}
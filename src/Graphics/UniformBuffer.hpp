@@ -0,0 +1,52 @@
+#ifndef UNIFORM_BUFFER_HPP
+#define UNIFORM_BUFFER_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include "system/NonCopyable.hpp"
+
+// Per-view data shared by every program through the FrameData block of frame.glsl.
+// The members follow the std140 rules: the mat4 takes 64 bytes and the vec2 + float pack into one 16-byte row
+struct FrameUniforms
+{
+    static constexpr unsigned Binding = 0;
+
+    glm::mat4 viewProjection { 1.0f };
+    glm::vec2 viewportSize   { 0.0f, 0.0f };
+    float     time           = 0.0f; // Seconds
+    float     padding        = 0.0f;
+};
+
+static_assert(sizeof(FrameUniforms) == 80, "FrameUniforms must match the std140 layout of FrameData");
+
+class UniformBuffer:
+    private NonCopyable
+{
+public:
+    UniformBuffer() noexcept;
+    ~UniformBuffer();
+
+//  Allocates the buffer and attaches it to the indexed binding point, where it stays for every program
+    bool create(std::size_t size, unsigned binding) noexcept;
+
+//  Uploads only when the content changed since the previous call
+    bool update(const void* data, std::size_t size, std::size_t offset = 0U) noexcept;
+
+    template<class T>
+    bool update(const T& block) noexcept
+    {
+        return update(&block, sizeof(T));
+    }
+
+    unsigned getBinding() const noexcept;
+
+private:
+    unsigned                   m_buffer;
+    unsigned                   m_binding;
+    std::vector<unsigned char> m_shadow; // Last uploaded content
+};
+
+#endif // !UNIFORM_BUFFER_HPP
@@ -0,0 +1,52 @@
+#ifndef ASSET_HANDLE_HPP
+#define ASSET_HANDLE_HPP
+
+#include <list>
+#include <cstdint>
+
+#include "system/StringId.hpp"
+
+// Bookkeeping that AssetManager keeps next to every asset
+template<class T>
+struct AssetRecord
+{
+    T             asset;
+    std::uint32_t refCount    = 0U;    // Live AssetHandle objects
+    bool          isPinned    = false; // Handed out as a raw pointer, so it is never evicted
+    bool          isEvictable = false; // Listed in the LRU queue
+    std::size_t   bytes       = 0U;    // Estimated memory footprint
+    StringId      name;                // Key of the record in its container
+    std::list<StringId>::iterator lruPosition;
+};
+
+// Reference-counted access to an asset owned by AssetManager.
+// When the last handle goes away the asset becomes a candidate for eviction.
+// Handles must not outlive the AssetManager.
+template<class T>
+class AssetHandle
+{
+public:
+    AssetHandle() noexcept;
+    AssetHandle(const AssetHandle& other) noexcept;
+    AssetHandle(AssetHandle&& other) noexcept;
+    ~AssetHandle();
+
+    AssetHandle& operator =(AssetHandle other) noexcept;
+
+    T* get()         const noexcept;
+    T* operator ->() const noexcept;
+    T& operator *()  const noexcept;
+    explicit operator bool() const noexcept;
+
+    void reset() noexcept;
+
+private:
+    friend class AssetManager;
+
+    explicit AssetHandle(AssetRecord<T>* record) noexcept;
+
+private:
+    AssetRecord<T>* m_record;
+};
+
+#endif // !ASSET_HANDLE_HPP
@@ -1,9 +1,434 @@
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+
 #include "managers/AssetManager.hpp"
 
 AssetManager* AssetManager::m_instance;
 
-AssetManager::AssetManager() noexcept
+AssetManager::AssetManager() noexcept:
+    m_textureBytes(0U),
+    m_textureBudget(SIZE_MAX),
+    m_nextTicket(1U),
+    m_pixelBuffers(),
+    m_nextPixelBuffer(0U)
 {
     if(!m_instance)
         m_instance = this;
-}
\ No newline at end of file
+}
+
+AssetManager::~AssetManager()
+{
+    if(m_pixelBuffers[0])
+        glDeleteBuffers(3, m_pixelBuffers);
+
+    if(m_instance == this)
+        m_instance = nullptr;
+}
+
+void AssetManager::update(std::size_t byteBudget) noexcept
+{
+    if( ! m_instance )
+        return;
+
+    m_instance->uploadDecoded(byteBudget);
+    m_instance->finishShaders();
+}
+
+bool AssetManager::wait(const std::vector<Shader*>& shaders) noexcept
+{
+    if( ! m_instance )
+        return false;
+
+    bool result = true;
+
+    for(auto shader : shaders)
+        result = (shader && shader->finish()) && result;
+
+    m_instance->finishShaders(); // Drops the ones finished above from the pending list
+
+    return result;
+}
+
+bool AssetManager::wait(const std::vector<Texture2D*>& textures) noexcept
+{
+    if( ! m_instance )
+        return false;
+
+    auto isPending = [](const Texture2D* texture)
+    {
+        for(const auto& [filename, ticket] : m_instance->m_pending)
+            if(auto it = m_instance->m_textures.find(filename); it != m_instance->m_textures.end() && &it->second.asset == texture)
+                return true;
+
+        return false;
+    };
+
+    for(;;)
+    {
+        m_instance->uploadDecoded(SIZE_MAX);
+
+        bool isDone = true;
+
+        for(auto texture : textures)
+            if(texture && isPending(texture))
+            {
+                isDone = false;
+                break;
+            }
+
+        if(isDone)
+            break;
+
+        std::unique_lock<std::mutex> lock(m_instance->m_mutex);
+        m_instance->m_decodedCondition.wait(lock, [] { return !m_instance->m_decoded.empty(); });
+    }
+
+    for(auto texture : textures)
+        if( ! texture || ! texture->isResident() )
+            return false;
+
+    return true;
+}
+
+void AssetManager::setTextureBudget(std::size_t bytes) noexcept
+{
+    if( ! m_instance )
+        return;
+
+    m_instance->m_textureBudget = bytes;
+    m_instance->trimTextures();
+}
+
+AssetManager::CacheStatistics AssetManager::getTextureStatistics() noexcept
+{
+    if( ! m_instance )
+        return {};
+
+    CacheStatistics stats = m_instance->m_stats;
+    stats.bytes  = m_instance->m_textureBytes;
+    stats.budget = m_instance->m_textureBudget;
+
+    return stats;
+}
+
+void AssetManager::clear() noexcept
+{
+    if( ! m_instance )
+        return;
+
+    for(auto it = m_instance->m_textures.begin(); it != m_instance->m_textures.end();)
+    {
+        auto next = std::next(it);
+        m_instance->eraseTexture(it);
+        it = next;
+    }
+
+    for(auto it = m_instance->m_failedTextures.begin(); it != m_instance->m_failedTextures.end();)
+    {
+        auto next = std::next(it);
+
+        if(it->second.refCount == 0U)
+            m_instance->eraseFailedTexture(it);
+
+        it = next;
+    }
+
+    for(auto it = m_instance->m_shaders.begin(); it != m_instance->m_shaders.end();)
+    {
+        if(it->second.refCount == 0U)
+            it = m_instance->m_shaders.erase(it);
+        else
+            ++it;
+    }
+
+    for(auto it = m_instance->m_failedShaders.begin(); it != m_instance->m_failedShaders.end();)
+    {
+        if(it->second.refCount == 0U)
+            it = m_instance->m_failedShaders.erase(it);
+        else
+            ++it;
+    }
+}
+
+AssetRecord<Texture2D>* AssetManager::loadTexture(const StringId& filename, const Image* decoded) noexcept
+{
+    if(m_failedTextures.count(filename))
+        return nullptr;
+
+    if(auto it = m_textures.find(filename); it != m_textures.end())
+    {
+        ++m_stats.hits;
+
+        if(m_pending.count(filename))
+        {
+            wait({ &it->second.asset }); // The caller expects the texture to be ready
+
+//          A failed decode took the record out of the cache
+            if(it = m_textures.find(filename); it == m_textures.end())
+                return nullptr;
+        }
+
+        return it->second.asset.isResident() ? &it->second : nullptr;
+    }
+
+    ++m_stats.misses;
+
+    auto iterator = m_textures.try_emplace(filename).first;
+    auto& record  = iterator->second;
+
+    bool isLoaded = false;
+
+    if(decoded)
+        isLoaded = record.asset.loadFromImage(*decoded);
+    else if(const FileView file = FileProvider().getFileView(filename.c_str()); !file.empty())
+        isLoaded = record.asset.loadFromMemory(file.data(), file.size());
+
+    if(!isLoaded)
+    {
+        m_textures.erase(iterator);
+
+        return nullptr;
+    }
+
+    record.name = iterator->first;
+    onTextureResident(record);
+
+    return &record;
+}
+
+AssetRecord<Texture2D>* AssetManager::requestTexture(const StringId& filename) noexcept
+{
+    if(m_failedTextures.count(filename))
+        return nullptr;
+
+    if(auto it = m_textures.find(filename); it != m_textures.end())
+    {
+        ++m_stats.hits;
+
+        return &it->second;
+    }
+
+    ++m_stats.misses;
+
+    auto iterator = m_textures.try_emplace(filename).first;
+    auto& record  = iterator->second;
+    record.name   = iterator->first;
+
+    if(!record.asset.createPlaceholder(Color::Transparent))
+    {
+        m_textures.erase(iterator);
+
+        return nullptr;
+    }
+
+    const std::uint64_t ticket = m_nextTicket++;
+    m_pending[filename] = ticket;
+
+    m_workers.push([this, filename, ticket]()
+    {
+        DecodedTexture decoded;
+        decoded.filename = filename;
+        decoded.ticket   = ticket;
+
+        if(const FileView file = FileProvider().getFileView(filename.c_str()); !file.empty())
+        {
+            auto image = std::make_unique<Image>();
+
+            if(image->loadFromMemory(file.data(), file.size()))
+                decoded.image = std::move(image);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_decoded.push_back(std::move(decoded));
+        }
+
+        m_decodedCondition.notify_all();
+    });
+
+    return &record;
+}
+
+bool AssetManager::uploadDecoded(std::size_t byteBudget) noexcept
+{
+    std::vector<DecodedTexture> decoded;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        decoded.swap(m_decoded);
+    }
+
+    if(decoded.empty())
+        return false;
+
+    if( ! m_pixelBuffers[0] )
+        glGenBuffers(3, m_pixelBuffers);
+
+    std::size_t uploaded = 0U;
+    std::size_t i = 0U;
+
+//  At least one texture goes through per call, however large it is
+    for(; i < decoded.size() && (i == 0U || uploaded < byteBudget); ++i)
+    {
+        auto& item = decoded[i];
+        auto pending = m_pending.find(item.filename);
+
+        if(pending == m_pending.end() || pending->second != item.ticket)
+            continue; // Removed or requested again while decoding
+
+        m_pending.erase(pending);
+
+        auto found = m_textures.find(item.filename);
+
+        if(found == m_textures.end())
+            continue;
+
+        if( ! item.image )
+        {
+            std::cerr << "Error: failed to load texture " << item.filename.c_str() << '\n';
+            failTexture(found);
+            continue;
+        }
+
+        const auto& size = item.image->getSize();
+        const std::size_t bytes = static_cast<std::size_t>(size.x) * size.y * 4U;
+
+//      Orphan the buffer so the driver can keep streaming the previous upload from it
+        const unsigned pbo = m_pixelBuffers[m_nextPixelBuffer];
+        m_nextPixelBuffer = (m_nextPixelBuffer + 1U) % 3U;
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+
+        if(void* ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT); ptr != nullptr)
+        {
+            std::memcpy(ptr, item.image->getPixels(), bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            found->second.asset.loadFromPixelBuffer(pbo, size);
+        }
+        else
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            found->second.asset.loadFromImage(*item.image);
+        }
+
+        onTextureResident(found->second);
+
+        uploaded += bytes;
+    }
+
+//  Whatever did not fit into the budget waits for the next call
+    if(i < decoded.size())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_decoded.insert(m_decoded.begin(), std::make_move_iterator(decoded.begin() + i), std::make_move_iterator(decoded.end()));
+    }
+
+    return true;
+}
+
+void AssetManager::finishShaders() noexcept
+{
+    for(std::size_t i = 0; i < m_pendingShaders.size();)
+    {
+        auto found = m_shaders.find(m_pendingShaders[i]);
+
+        if(found != m_shaders.end() && found->second.asset.isPending() && ! found->second.asset.isReady())
+        {
+            ++i;
+            continue;
+        }
+
+        m_pendingShaders[i] = m_pendingShaders.back();
+        m_pendingShaders.pop_back();
+
+//      Also catches the programs wait() or get() finished in the meantime
+        if(found != m_shaders.end() && ! found->second.asset.finish())
+        {
+            std::cerr << "Error: failed to build shader " << found->first.c_str() << '\n';
+            failShader(found);
+        }
+    }
+}
+
+void AssetManager::onTextureResident(AssetRecord<Texture2D>& record) noexcept
+{
+    const auto& size = record.asset.getSize();
+
+    m_textureBytes -= record.bytes;
+    record.bytes    = static_cast<std::size_t>(size.x) * size.y * 4U * 4U / 3U; // The mipmap chain adds a third
+    m_textureBytes += record.bytes;
+
+    trimTextures();
+}
+
+void AssetManager::listEvictable(AssetRecord<Texture2D>* record) noexcept
+{
+    if(record->isEvictable)
+        return;
+
+//  Failed textures are out of the cache, there is nothing to evict
+    if(auto it = m_textures.find(record->name); it == m_textures.end() || &it->second != record)
+        return;
+
+    record->lruPosition = m_lru.insert(m_lru.begin(), record->name);
+    record->isEvictable = true;
+
+    trimTextures();
+}
+
+void AssetManager::trimTextures() noexcept
+{
+    while(m_textureBytes > m_textureBudget && ! m_lru.empty())
+    {
+        if(auto it = m_textures.find(m_lru.back()); it == m_textures.end())
+            m_lru.pop_back();
+        else if(eraseTexture(it))
+            ++m_stats.evictions;
+        else
+            unlistEvictable(&it->second);
+    }
+}
+
+bool AssetManager::eraseTexture(std::unordered_map<StringId, AssetRecord<Texture2D>>::iterator it) noexcept
+{
+    auto& record = it->second;
+
+    if(record.refCount > 0U)
+    {
+        std::cerr << "Warning: texture " << it->first.c_str() << " is still referenced and can not be removed\n";
+
+        return false;
+    }
+
+    unlistEvictable(&record);
+    m_textureBytes -= record.bytes;
+    m_pending.erase(it->first);
+    m_textures.erase(it);
+
+    return true;
+}
+
+void AssetManager::failTexture(std::unordered_map<StringId, AssetRecord<Texture2D>>::iterator it) noexcept
+{
+    unlistEvictable(&it->second);
+    m_textureBytes -= it->second.bytes;
+    it->second.bytes = 0U;
+
+//  Extracting keeps the node, and so every pointer to the record, valid
+    m_failedTextures.insert(m_textures.extract(it));
+}
+
+void AssetManager::failShader(std::unordered_map<StringId, AssetRecord<Shader>>::iterator it) noexcept
+{
+    m_failedShaders.insert(m_shaders.extract(it));
+}
+
+void AssetManager::eraseFailedTexture(std::unordered_map<StringId, AssetRecord<Texture2D>>::iterator it) noexcept
+{
+    unlistEvictable(&it->second);
+    m_failedTextures.erase(it);
+}
@@ -2,52 +2,129 @@
 #define ASSET_MANAGER_HPP
 
 #include <string>
+#include <iostream>
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 #include <unordered_map>
 #include <type_traits>
+#include <cstdint>
 
 #include <glad/glad.h>
 
 #include "system/NonCopyable.hpp"
 #include "system/FileProvider.hpp"
+#include "system/ThreadPool.hpp"
+#include "system/StringId.hpp"
 #include "graphics/Image.hpp"
 #include "graphics/Texture2D.hpp"
 #include "graphics/Shader.hpp"
+#include "managers/AssetHandle.hpp"
 
 class AssetManager:
 	private NonCopyable
 {
+public:
+    struct CacheStatistics
+    {
+        std::uint64_t hits      = 0U;
+        std::uint64_t misses    = 0U;
+        std::uint64_t evictions = 0U;
+        std::size_t   bytes     = 0U; // Estimated memory of the resident textures, mipmaps included
+        std::size_t   budget    = 0U;
+    };
+
 public:
     AssetManager() noexcept;
-    ~AssetManager() = default;
+    ~AssetManager();
 
+//  Raw pointers pin the asset: it stays loaded until remove() or clear().
+//  A texture can be given the Image already decoded from its file, which is then uploaded instead of decoding it again
     template <class T, class... Args>
-    static T* get(const std::string& filename, Args&& ...args) noexcept
+    static T* get(const StringId& filename, Args&& ...args) noexcept
     {
-        if(m_instance)
-        {
-//          Textures
-            if constexpr (std::is_same<T, Texture2D>::value)
-            {
-                if(auto it = m_instance->m_textures.find(filename); it != m_instance->m_textures.end())
-                    return &it->second;
+        auto record = findOrLoad<T>(filename, std::forward<Args>(args)...);
 
-                return tryLoadFromFile<Texture2D>(filename, m_instance->m_textures);
-            }
-//          Shaders
-            else if constexpr (std::is_same<T, Shader>::value)
+        if( ! record )
+            return nullptr;
+
+        m_instance->pin(record);
+
+        return &record->asset;
+    }
+
+//  Returns at once: the texture holds a placeholder until a worker has decoded it and update() or wait() has uploaded it;
+//  the shader is compiled and linked by the driver in the background and finished by update() or wait()
+    template <class T, class... Args>
+    static T* getAsync(const StringId& filename, Args&& ...args) noexcept
+    {
+        if( ! m_instance )
+            return nullptr;
+
+        AssetRecord<T>* record = nullptr;
+
+        if constexpr (std::is_same<T, Texture2D>::value)
+            record = m_instance->requestTexture(filename);
+        else if constexpr (std::is_same<T, Shader>::value)
+            record = m_instance->requestShader(filename, std::forward<Args>(args)...);
+
+        if( ! record )
+            return nullptr;
+
+        m_instance->pin(record);
+
+        return &record->asset;
+    }
+
+//  Handles keep the asset alive while they exist; afterwards it is evicted least-recently-used first
+    template <class T, class... Args>
+    static AssetHandle<T> acquire(const StringId& filename, Args&& ...args) noexcept
+    {
+        auto record = findOrLoad<T>(filename, std::forward<Args>(args)...);
+
+        if( ! record )
+            return AssetHandle<T>();
+
+        m_instance->retain(record);
+
+        return AssetHandle<T>(record);
+    }
+
+    template <class T>
+    static AssetHandle<T> acquireAsync(const StringId& filename) noexcept
+    {
+        if constexpr (std::is_same<T, Texture2D>::value)
+        {
+            if(m_instance)
             {
-                if(auto it = m_instance->m_shaders.find(filename); it != m_instance->m_shaders.end())
-                    return &it->second;
+                if(auto record = m_instance->requestTexture(filename); record != nullptr)
+                {
+                    m_instance->retain(record);
 
-                return tryLoadFromFile<Shader>(filename, m_instance->m_shaders, std::forward<Args>(args)...);
+                    return AssetHandle<T>(record);
+                }
             }
         }
 
-        return nullptr;
+        return AssetHandle<T>();
     }
 
+//  Uploads decoded textures through pixel buffer objects. Must be called on the GL thread
+    static void update(std::size_t byteBudget = 32U << 20) noexcept;
+
+//  Blocks until every texture in the group is resident or has failed. Must be called on the GL thread
+    static bool wait(const std::vector<Texture2D*>& textures) noexcept;
+    static bool wait(const std::vector<Shader*>& shaders)     noexcept;
+
+//  Unreferenced textures are evicted while the resident ones exceed the budget
+    static void setTextureBudget(std::size_t bytes) noexcept;
+    static CacheStatistics getTextureStatistics() noexcept;
+
+//  Assets still referenced by a handle are kept
     template<class T>
-    static void remove(const std::string& filename) noexcept
+    static void remove(const StringId& filename) noexcept
     {
         if( ! m_instance )
             return;
@@ -56,71 +133,250 @@ public:
         if constexpr (std::is_same<T, Texture2D>::value)
         {
             if(auto it = m_instance->m_textures.find(filename); it != m_instance->m_textures.end())
-                m_instance->m_textures.erase(it);
+                m_instance->eraseTexture(it);
+            else if(auto failed = m_instance->m_failedTextures.find(filename); failed != m_instance->m_failedTextures.end() && failed->second.refCount == 0U)
+                m_instance->eraseFailedTexture(failed); // The next request tries the file again
         }
 //      Shaders
         else if constexpr (std::is_same<T, Shader>::value)
         {
-            if(auto it = m_instance->m_shaders.find(filename); it != m_instance->m_shaders.end())
+            if(auto it = m_instance->m_shaders.find(filename); it != m_instance->m_shaders.end() && it->second.refCount == 0U)
                 m_instance->m_shaders.erase(it);
+            else if(auto failed = m_instance->m_failedShaders.find(filename); failed != m_instance->m_failedShaders.end() && failed->second.refCount == 0U)
+                m_instance->m_failedShaders.erase(failed);
         }
     }
 
-    static void clear() noexcept
-    {
-        if( ! m_instance )
-            return;
-
-        m_instance->m_textures.clear();
-    }
+    static void clear() noexcept;
 
 private:
     template<class T, class... Args>
-    static T* tryLoadFromFile(const std::string& filename, std::unordered_map<std::string, T>& container, Args&& ...args) noexcept
+    static AssetRecord<T>* findOrLoad(const StringId& filename, Args&& ...args) noexcept
     {
-        if constexpr (std::is_same<T, Shader>::value)
+        if( ! m_instance )
+            return nullptr;
+
+//      Textures
+        if constexpr (std::is_same<T, Texture2D>::value)
         {
-            auto [iterator, result] = container.try_emplace(filename);
+            return m_instance->loadTexture(filename, std::forward<Args>(args)...);
+        }
+//      Shaders
+        else if constexpr (std::is_same<T, Shader>::value)
+        {
+            if (m_instance->m_failedShaders.count(filename))
+                return nullptr;
 
-            if (result)
+            auto [iterator, result] = m_instance->m_shaders.try_emplace(filename);
+
+            if (!result)
             {
-                auto shader = &iterator->second;
+//              The caller expects a linked program, blocks if the build is still running
+                if (iterator->second.asset.finish())
+                    return &iterator->second;
+
+                std::cerr << "Error: failed to build shader " << filename.c_str() << '\n';
+                m_instance->failShader(iterator);
 
-                if (!shader->compile(std::forward<Args>(args)...))          
-                    container.erase(filename);
-                else
-                    return shader;
+                return nullptr;
             }
+
+            if (iterator->second.asset.compile(std::forward<Args>(args)...))
+                return &iterator->second;
+
+            m_instance->m_shaders.erase(iterator);
         }
-        else // Image, Texture2D...
+
+        return nullptr;
+    }
+
+    template<class T>
+    void pin(AssetRecord<T>* record) noexcept
+    {
+        record->isPinned = true;
+        unlistEvictable(record);
+    }
+
+    template<class T>
+    void retain(AssetRecord<T>* record) noexcept
+    {
+        ++record->refCount;
+        unlistEvictable(record);
+    }
+
+    template<class T>
+    void unlistEvictable(AssetRecord<T>* record) noexcept
+    {
+        if(record->isEvictable)
         {
-            const std::string filepath = FileProvider().getPathToFile(filename);
+            m_lru.erase(record->lruPosition);
+            record->isEvictable = false;
+        }
+    }
 
-            if (!filepath.empty())
-            {
-                auto [iterator, result] = container.try_emplace(filename);
+    template<class T>
+    static void release(AssetRecord<T>* record) noexcept
+    {
+        if(record->refCount > 0U)
+            --record->refCount;
 
-                if (result)
-                {
-                    auto& texture = iterator->second;
+        if constexpr (std::is_same<T, Texture2D>::value)
+        {
+            if(m_instance && record->refCount == 0U && !record->isPinned)
+                m_instance->listEvictable(record);
+        }
+    }
 
-                    if(!texture.loadFromFile(filepath))
-                        container.erase(filename);                
-                    else           
-                        return &texture;
-                }
-            }
+    template<class... Args>
+    AssetRecord<Shader>* requestShader(const StringId& filename, Args&& ...args) noexcept
+    {
+        if (m_failedShaders.count(filename))
+            return nullptr;
+
+        auto [iterator, result] = m_shaders.try_emplace(filename);
+
+        if (!result)
+            return &iterator->second;
+
+        if (!iterator->second.asset.compileAsync(std::forward<Args>(args)...))
+        {
+            m_shaders.erase(iterator);
+
+            return nullptr;
         }
 
-        return nullptr;
+        if (iterator->second.asset.isPending())
+            m_pendingShaders.push_back(filename);
+
+        return &iterator->second;
     }
 
+    void finishShaders() noexcept;
+    void failShader(std::unordered_map<StringId, AssetRecord<Shader>>::iterator it) noexcept; // Like failTexture
+
+    AssetRecord<Texture2D>* loadTexture(const StringId& filename, const Image* decoded = nullptr) noexcept;
+    AssetRecord<Texture2D>* requestTexture(const StringId& filename) noexcept;
+    bool uploadDecoded(std::size_t byteBudget) noexcept;
+    void onTextureResident(AssetRecord<Texture2D>& record) noexcept;
+    void listEvictable(AssetRecord<Texture2D>* record) noexcept;
+    void trimTextures() noexcept;
+    bool eraseTexture(std::unordered_map<StringId, AssetRecord<Texture2D>>::iterator it) noexcept;
+
+//  A texture that failed to decode leaves the cache, so later requests get nullptr. Its record lives on,
+//  since the placeholder was already handed out
+    void failTexture(std::unordered_map<StringId, AssetRecord<Texture2D>>::iterator it) noexcept;
+    void eraseFailedTexture(std::unordered_map<StringId, AssetRecord<Texture2D>>::iterator it) noexcept;
+
 private:
-    std::unordered_map<std::string, Texture2D> m_textures;
-    std::unordered_map<std::string, Shader>    m_shaders;
+    template<class T>
+    friend class AssetHandle;
+
+    struct DecodedTexture
+    {
+        StringId               filename;
+        std::uint64_t          ticket = 0U;
+        std::unique_ptr<Image> image; // nullptr if decoding failed
+    };
+
+    std::unordered_map<StringId, AssetRecord<Texture2D>> m_textures;
+    std::unordered_map<StringId, AssetRecord<Texture2D>> m_failedTextures; // Until remove() or clear()
+    std::unordered_map<StringId, AssetRecord<Shader>>    m_shaders;
+    std::unordered_map<StringId, AssetRecord<Shader>>    m_failedShaders; // Until remove() or clear()
+
+//  Texture cache
+    std::list<StringId>      m_lru; // Unreferenced textures, most recently released first
+    std::size_t            m_textureBytes;
+    std::size_t            m_textureBudget;
+    CacheStatistics        m_stats;
+
+//  Async texture loading
+    std::unordered_map<StringId, std::uint64_t> m_pending; // filename -> ticket of the request in flight
+    std::vector<StringId>       m_pendingShaders; // Programs the driver may still be building
+    std::vector<DecodedTexture> m_decoded; // Filled by the workers, guarded by m_mutex
+    std::mutex                  m_mutex;
+    std::condition_variable     m_decodedCondition;
+    std::uint64_t               m_nextTicket;
+    unsigned                    m_pixelBuffers[3];
+    unsigned                    m_nextPixelBuffer;
+    ThreadPool                  m_workers; // Declared last: joined before the containers above are destroyed
 
 private:
     static AssetManager* m_instance;
 };
 
+template<class T>
+AssetHandle<T>::AssetHandle() noexcept:
+    m_record(nullptr)
+{
+}
+
+template<class T>
+AssetHandle<T>::AssetHandle(AssetRecord<T>* record) noexcept:
+    m_record(record)
+{
+}
+
+template<class T>
+AssetHandle<T>::AssetHandle(const AssetHandle& other) noexcept:
+    m_record(other.m_record)
+{
+    if(m_record)
+        ++m_record->refCount;
+}
+
+template<class T>
+AssetHandle<T>::AssetHandle(AssetHandle&& other) noexcept:
+    m_record(other.m_record)
+{
+    other.m_record = nullptr;
+}
+
+template<class T>
+AssetHandle<T>::~AssetHandle()
+{
+    reset();
+}
+
+template<class T>
+AssetHandle<T>& AssetHandle<T>::operator =(AssetHandle other) noexcept
+{
+    std::swap(m_record, other.m_record);
+
+    return *this;
+}
+
+template<class T>
+T* AssetHandle<T>::get() const noexcept
+{
+    return m_record ? &m_record->asset : nullptr;
+}
+
+template<class T>
+T* AssetHandle<T>::operator ->() const noexcept
+{
+    return get();
+}
+
+template<class T>
+T& AssetHandle<T>::operator *() const noexcept
+{
+    return m_record->asset;
+}
+
+template<class T>
+AssetHandle<T>::operator bool() const noexcept
+{
+    return m_record != nullptr;
+}
+
+template<class T>
+void AssetHandle<T>::reset() noexcept
+{
+    if(m_record)
+    {
+        AssetManager::release(m_record);
+        m_record = nullptr;
+    }
+}
+
 #endif
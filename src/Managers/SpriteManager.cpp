@@ -1,17 +1,28 @@
 #include <memory>
+#include <iostream>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <iterator>
 
 #include <glad/glad.h>
 
-#include "rapidxml_ext.h"
-#include "rapidxml_utils.hpp"
+#include "rapidxml.hpp"
 
 #include "system/FileProvider.hpp"
+#include "system/ThreadPool.hpp"
+#include "managers/AssetManager.hpp"
+#include "graphics/Image.hpp"
 #include "graphics/Texture2D.hpp"
 #include "graphics/Sprite2D.hpp"
+#include "graphics/PackedVertex2D.hpp"
 #include "managers/SpriteManager.hpp"
 
 SpriteManager::SpriteManager() noexcept:
-	m_vao(0u), m_vbo(0u)
+	m_vertices(GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW),
+	m_frameTable(GL_SHADER_STORAGE_BUFFER, GL_DYNAMIC_DRAW),
+	m_uploadedFrames(0u),
+	m_vao(0u)
 {
 }
 
@@ -20,7 +31,7 @@ SpriteManager::~SpriteManager()
 	reset();
 }
 
-bool SpriteManager::createFrame(const std::string& name, const Texture2D* texture, const glm::ivec4& frame) noexcept
+bool SpriteManager::createFrame(const StringId& name, const Texture2D* texture, const glm::ivec4& frame) noexcept
 {
 	if (!texture)
 		return false;
@@ -31,17 +42,16 @@ bool SpriteManager::createFrame(const std::string& name, const Texture2D* textur
 		return false; // Already in the container
 
 	auto& anim    = it.first->second;
-	auto& sprites = m_sprites.emplace_back();
 	auto  ratio   = 1.0f / glm::vec2(texture->getSize());
+	anim.first    = m_frames.getSize();
 	anim.duration = 1;
 
-	createSpriteFromFrame(frame, ratio, sprites, texture->getNativeHandle());
-	anim.sprites = sprites.data();
+	createSpriteFromFrame(frame, ratio, texture->getNativeHandle());
 
 	return true;
 }
 
-bool SpriteManager::createLinearAnimaton(const std::string& name, const Texture2D* texture, int duration, int delay) noexcept
+bool SpriteManager::createLinearAnimaton(const StringId& name, const Texture2D* texture, int duration, int delay, const TrimOptions* trim) noexcept
 {
 	if (!texture)
 		return false;
@@ -52,25 +62,26 @@ bool SpriteManager::createLinearAnimaton(const std::string& name, const Texture2
 		return false; // Already in the container
 
 	auto& anim    = it.first->second;
-	auto& sprites = m_sprites.emplace_back();
+	anim.first    = m_frames.getSize();
 	anim.delay    = delay;
 	anim.duration = duration;
 
-	sprites.reserve(static_cast<std::size_t>(duration));
+	m_frames.reserve(m_frames.getSize() + static_cast<std::size_t>(duration));
 
 	auto size      = glm::vec2(texture->getSize());
 	auto ratio     = 1.0f / size;
 	int frameWidth = size.x / duration;
 
 	for (int i = 0; i < duration; ++i)
-		createSpriteFromFrame(glm::ivec4(i * frameWidth, 0, frameWidth, size.y), ratio, sprites, texture->getNativeHandle());
+		createSpriteFromFrame(glm::ivec4(i * frameWidth, 0, frameWidth, size.y), ratio, texture->getNativeHandle());
 
-	anim.sprites = sprites.data();
+	if (trim)
+		trimFrames(anim, *texture, *trim, m_trimStatistics[name]);
 	
     return true;
 }
 
-bool SpriteManager::createGridAnimaton(const std::string& name, const Texture2D* texture, int columns, int rows, int delay) noexcept
+bool SpriteManager::createGridAnimaton(const StringId& name, const Texture2D* texture, int columns, int rows, int delay, const TrimOptions* trim) noexcept
 {
 	if (!texture)
 		return false;
@@ -81,11 +92,11 @@ bool SpriteManager::createGridAnimaton(const std::string& name, const Texture2D*
 		return false; // Already in the container
 
 	auto& anim    = it.first->second;
-	auto& sprites = m_sprites.emplace_back();
+	anim.first    = m_frames.getSize();
 	anim.delay    = delay;
 	anim.duration = columns * rows;
 
-	sprites.reserve(static_cast<std::size_t>(columns * rows));
+	m_frames.reserve(m_frames.getSize() + static_cast<std::size_t>(columns * rows));
 
 	auto size       = glm::vec2(texture->getSize());
 	auto ratio      = 1.0f / size;
@@ -94,14 +105,15 @@ bool SpriteManager::createGridAnimaton(const std::string& name, const Texture2D*
 
 	for (int y = 0; y < rows; ++y)
 		for (int x = 0; x < columns; ++x)	
-			createSpriteFromFrame(glm::ivec4(x * frameWidth, y * frameHeight, frameWidth, frameHeight), ratio, sprites, texture->getNativeHandle());
+			createSpriteFromFrame(glm::ivec4(x * frameWidth, y * frameHeight, frameWidth, frameHeight), ratio, texture->getNativeHandle());
 
-	anim.sprites = sprites.data();
+	if (trim)
+		trimFrames(anim, *texture, *trim, m_trimStatistics[name]);
 
     return true;
 }
 
-bool SpriteManager::loadSpriteSheet(const std::string& filename, const Texture2D* texture) noexcept
+bool SpriteManager::loadSpriteSheet(const StringId& filename, const Texture2D* texture, const TrimOptions* trim) noexcept
 {
 	if (!texture)
 		return false;
@@ -109,14 +121,17 @@ bool SpriteManager::loadSpriteSheet(const std::string& filename, const Texture2D
 	if(auto found = m_spriteSheets.find(filename); found != m_spriteSheets.end())
 		return true; // Already loaded
 
-	const std::string filepath = FileProvider().getPathToFile(filename);
+	const FileView file = FileProvider().getFileView(filename.c_str());
 
-	if(filepath.empty())
+	if(file.empty())
 		return false;
 
+//	rapidxml parses in situ, so it gets a writable, null-terminated copy of the mapped bytes
+	std::vector<char> xmlText(file.data(), file.data() + file.size());
+	xmlText.push_back('\0');
+
 	auto document = std::make_unique<rapidxml::xml_document<char>>();
-	rapidxml::file<char> xmlFile(filepath.c_str());
-	document->parse<0>(xmlFile.data());
+	document->parse<0>(xmlText.data());
 	const auto spriteNode = document->first_node("sprites");
 
 	auto ssIt = m_spriteSheets.try_emplace(filename);
@@ -132,20 +147,19 @@ bool SpriteManager::loadSpriteSheet(const std::string& filename, const Texture2D
 		     animNode != nullptr;
 		     animNode = animNode->next_sibling("animation"))
 	{
-		std::string title;
-
-		if(auto ptr = animNode->first_attribute("title"); ptr != nullptr)
-			title = ptr->value();
+		auto pTitle = animNode->first_attribute("title");
 
-		if(title.empty())
+		if(!pTitle || *pTitle->value() == '\0')
 			continue;
 
+		const StringId title(std::string(pTitle->value()));
+
 		if(auto it = m_animations.try_emplace(title); it.second)
 		{
 			auto delay = animNode->first_attribute("delay");
 
 			auto& anim    = it.first->second;
-			auto& sprites = m_sprites.emplace_back();
+			anim.first    = m_frames.getSize();
 			anim.delay    = delay ? std::atoi(delay->value()): 0; 
 
 			auto cutNode = animNode->first_node("cut");
@@ -162,44 +176,149 @@ bool SpriteManager::loadSpriteSheet(const std::string& filename, const Texture2D
 				int w = pW ? atoi(pW->value()) : 0;
 				int h = pH ? atoi(pH->value()) : 0;
 
-				createSpriteFromFrame(glm::ivec4(x, y, w, h), ratio, sprites, texture->getNativeHandle());
+				createSpriteFromFrame(glm::ivec4(x, y, w, h), ratio, texture->getNativeHandle());
 
 				cutNode = cutNode->next_sibling();
 			}
 
-			anim.sprites = sprites.data();
+			anim.duration = m_frames.getSize() - anim.first;
 			spriteSheet.emplace(title, anim);
 		}
 	}
 
+//	One entry for the whole sheet
+	if (trim)
+	{
+		TrimStatistics statistics;
+
+		for (const auto& [title, animation] : spriteSheet)
+			trimFrames(animation, *texture, *trim, statistics);
+
+		m_trimStatistics[filename] = statistics;
+	}
+
     return true;
 }
 
+bool SpriteManager::loadSpriteSheets(const std::vector<std::pair<StringId, StringId>>& sheets) noexcept
+{
+	std::vector<Texture2D*> textures;
+	textures.reserve(sheets.size());
+
+	for (const auto& [sheet, texture] : sheets)
+		textures.push_back(AssetManager::getAsync<Texture2D>(texture));
+
+	AssetManager::wait(textures);
+
+	bool result = true;
+
+	for (std::size_t i = 0; i < sheets.size(); ++i)
+	{
+		const Texture2D* texture = (textures[i] && textures[i]->isResident()) ? textures[i] : nullptr;
+		result = loadSpriteSheet(sheets[i].first, texture) && result;
+	}
+
+	return result;
+}
+
+const SpriteManager::TrimStatistics* SpriteManager::getTrimStatistics(const StringId& name) const noexcept
+{
+	auto found = m_trimStatistics.find(name);
+
+	return (found != m_trimStatistics.end()) ? &found->second : nullptr;
+}
+
 void SpriteManager::unloadOnGPU() noexcept
 {
-	if(m_vertexBuffer.empty())
+	const std::uint32_t first = m_uploadedFrames;
+	const std::uint32_t count = m_frames.getSize() - first;
+
+	if(count == 0U)
 		return;
 
-	reset();
+	std::vector<PackedVertex2D> vertices;
+	std::vector<FrameData>      frameTable(count);
+	vertices.reserve(count * SpriteOutline::MaxVertices);
+
+//	The meshes land right after the ones already resident, so firstVertices is the offset on the GPU too
+	const auto firstVertex = static_cast<unsigned>(m_vertices.getSize() / sizeof(PackedVertex2D));
 
-	glGenVertexArrays(1, &m_vao);
-	glGenBuffers(1, &m_vbo);
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		const auto& uv      = m_frames.texCoords[first + i];
+		const auto& outline = m_frames.outlines[first + i];
+		const auto  size    = glm::vec2(m_frames.widths[first + i], m_frames.heights[first + i]);
+
+		m_frames.firstVertices[first + i] = firstVertex + static_cast<unsigned>(vertices.size());
 
-	glBindVertexArray(m_vao);
+		for (std::uint32_t j = 0; j < outline.count; ++j)
+		{
+			const auto& point = outline.points[j];
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex2D) * m_vertexBuffer.size(), m_vertexBuffer.data(), GL_STATIC_DRAW);
+			vertices.emplace_back(point.x, point.y, uv.x + (uv.z - uv.x) * point.x / size.x, uv.y + (uv.w - uv.y) * point.y / size.y);
+		}
+
+		frameTable[i].texCoords = uv;
+		frameTable[i].size      = size;
+		frameTable[i].padding   = glm::vec2(0.0f, 0.0f);
+
+//		The instanced path always draws MaxVertices corners, a quad's extra ones repeat its last point
+		for (std::uint32_t j = 0; j < SpriteOutline::MaxVertices; ++j)
+			frameTable[i].outline[j] = std::uint32_t(outline.points[j].x) | std::uint32_t(outline.points[j].y) << 16;
+	}
 
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), nullptr);
-	glEnableVertexAttribArray(0);
+	const unsigned vbo   = m_vertices.getNativeHandle();
+	const unsigned table = m_frameTable.getNativeHandle();
 
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), (void*)offsetof(Vertex2D, texCoords));
-	glEnableVertexAttribArray(1);
+	const std::size_t vertexBytes = sizeof(PackedVertex2D) * vertices.size();
+	const std::size_t tableBytes  = sizeof(FrameData) * frameTable.size();
+
+//	Both buffers grow before either is written, so a failure leaves the frame indices and the vertices in step
+	auto makeRoom = [](GrowableBuffer& buffer, std::size_t bytes)
+	{
+		return buffer.getSize() + bytes <= buffer.getCapacity() || buffer.reserve(std::max(buffer.getSize() + bytes, buffer.getCapacity() * 2U));
+	};
+
+	const bool hasRoom = makeRoom(m_vertices, vertexBytes) && makeRoom(m_frameTable, tableBytes);
+
+	if(hasRoom)
+	{
+		m_vertices.append(vertices.data(), vertexBytes);
+		m_frameTable.append(frameTable.data(), tableBytes);
+	}
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	if(!m_vao)
+		glGenVertexArrays(1, &m_vao);
+
+//	A grown buffer has a new name: the vertex array and the storage binding have to follow it
+	if(m_vertices.getNativeHandle() != vbo)
+	{
+		glBindVertexArray(m_vao);
+
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertices.getNativeHandle());
+
+		glVertexAttribPointer(0, 2, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(PackedVertex2D), nullptr);
+		glEnableVertexAttribArray(0);
+
+		glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex2D), (void*)offsetof(PackedVertex2D, texCoords));
+		glEnableVertexAttribArray(1);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+	if(m_frameTable.getNativeHandle() != table)
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, FrameTableBinding, m_frameTable.getNativeHandle());
+
+//	A failed reservation may still have grown the other buffer, which the bindings above follow
+	if(!hasRoom)
+	{
+		std::cerr << "Error: failed to upload " << count << " sprite frames\n";
+
+		return;
+	}
 
-	m_vertexBuffer.clear();
+	m_uploadedFrames = m_frames.getSize();
 }
 
 void SpriteManager::bind(bool on) noexcept
@@ -215,11 +334,9 @@ void SpriteManager::reset() noexcept
 		m_vao = 0u;
 	}
 
-	if(m_vbo)
-	{
-		glDeleteBuffers(1, &m_vbo);
-		m_vbo = 0u;
-	}
+	m_vertices.clear();
+	m_frameTable.clear();
+	m_uploadedFrames = 0u;
 }
 
 void SpriteManager::draw(const Sprite2D& sprite) const noexcept
@@ -227,45 +344,142 @@ void SpriteManager::draw(const Sprite2D& sprite) const noexcept
 	if(sprite.texture)
 	{
 		glBindTexture(GL_TEXTURE_2D, sprite.texture);
-		glDrawArrays(GL_TRIANGLE_FAN, sprite.frame, 4);
+		glDrawArrays(GL_TRIANGLE_FAN, sprite.frame, sprite.vertexCount);
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
 }
 
-void SpriteManager::createSpriteFromFrame(const glm::ivec4& frame, const glm::vec2& ratio, std::vector<Sprite2D>& sprites, unsigned texture) noexcept
+Sprite2D SpriteManager::getSprite(std::uint32_t index) const noexcept
 {
-	m_vertexBuffer.emplace_back();
-	m_vertexBuffer.emplace_back();
-	m_vertexBuffer.emplace_back();
-	m_vertexBuffer.emplace_back();
-
-	auto number    = static_cast<unsigned>(m_vertexBuffer.size() - 4);
-	auto& sprite   = sprites.emplace_back();
-	sprite.frame   = number; // offset to first vertex of the quad
-	sprite.texture = texture;
-	sprite.width   = static_cast<unsigned>(frame.z);
-	sprite.height  = static_cast<unsigned>(frame.w);
-
-	Vertex2D* quad     = &m_vertexBuffer[number];
-	quad[1].position.x = static_cast<float>(frame.z);
-	quad[2].position.x = static_cast<float>(frame.z);
-	quad[2].position.y = static_cast<float>(frame.w);
-	quad[3].position.y = static_cast<float>(frame.w);
+	Sprite2D sprite;
 
+	if(index < m_frames.getSize())
+	{
+		sprite.texture     = m_frames.textures[index];
+		sprite.frame       = m_frames.firstVertices[index];
+		sprite.width       = m_frames.widths[index];
+		sprite.height      = m_frames.heights[index];
+		sprite.texCoords   = m_frames.texCoords[index];
+		sprite.index       = index;
+		sprite.vertexCount = m_frames.outlines[index].count;
+
+		std::copy(std::begin(m_frames.outlines[index].points), std::end(m_frames.outlines[index].points), sprite.outline);
+	}
+
+	return sprite;
+}
+
+std::size_t SpriteManager::getFrameCount() const noexcept
+{
+	return m_frames.getSize();
+}
+
+SpriteManager::UploadStatistics SpriteManager::getUploadStatistics() const noexcept
+{
+	UploadStatistics statistics;
+	statistics.frames        = m_uploadedFrames;
+	statistics.capacity      = static_cast<std::uint32_t>(m_frameTable.getCapacity() / sizeof(FrameData));
+	statistics.uploadedBytes = m_vertices.getStatistics().uploadedBytes + m_frameTable.getStatistics().uploadedBytes;
+	statistics.reallocations = m_vertices.getStatistics().reallocations + m_frameTable.getStatistics().reallocations;
+	statistics.savedBytes    = m_vertices.getSize() / sizeof(PackedVertex2D) * (sizeof(Vertex2D) - sizeof(PackedVertex2D));
+
+	return statistics;
+}
+
+std::uint32_t SpriteManager::getFrameIndex(const Sprite2D& sprite) noexcept
+{
+	return sprite.index;
+}
+
+void SpriteManager::createSpriteFromFrame(const glm::ivec4& frame, const glm::vec2& ratio, unsigned texture) noexcept
+{
 	float left   = frame.x * ratio.x;
 	float top    = frame.y * ratio.y;
 	float right  = (frame.x + frame.z) * ratio.x;
 	float bottom = (frame.y + frame.w) * ratio.y;
 
-	quad[0].texCoords.x = left;
-	quad[0].texCoords.y = top;
+	m_frames.textures.push_back(texture);
+	m_frames.firstVertices.push_back(0U);
+	m_frames.widths.push_back(static_cast<unsigned>(frame.z));
+	m_frames.heights.push_back(static_cast<unsigned>(frame.w));
+	m_frames.texCoords.emplace_back(left, top, right, bottom);
+	m_frames.outlines.emplace_back().setQuad(static_cast<unsigned>(frame.z), static_cast<unsigned>(frame.w));
+}
+
+bool SpriteManager::trimFrames(const Animation& animation, const Texture2D& texture, const TrimOptions& trim, TrimStatistics& statistics) noexcept
+{
+	const std::uint32_t first = animation.first;
+	const std::uint32_t count = animation.duration;
+
+//	Only frames that are not on the GPU yet can be trimmed, which the loaders guarantee
+	if(first < m_uploadedFrames || first + count > m_frames.getSize())
+		return false;
+
+	if(!trim.image || trim.image->getSize() != texture.getSize())
+	{
+		std::cerr << "Error: frames can only be trimmed against the image of their texture\n";
+
+		return false;
+	}
 
-	quad[1].texCoords.x = right;
-	quad[1].texCoords.y = top;
+//	The frame rectangles are recovered from the texture coordinates, in pixels of the image
+	const Image&      image     = *trim.image;
+	const auto        imageSize = glm::vec2(image.getSize());
+	std::vector<char> isTraced(count, 0);
 
-	quad[2].texCoords.x = right;
-	quad[2].texCoords.y = bottom;
+	auto trace = [&](std::size_t, std::size_t begin, std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			const auto& uv = m_frames.texCoords[first + i];
+			const glm::ivec4 frame(static_cast<int>(std::lround(uv.x * imageSize.x)), static_cast<int>(std::lround(uv.y * imageSize.y)), m_frames.widths[first + i], m_frames.heights[first + i]);
+
+			SpriteOutline outline;
 
-	quad[3].texCoords.x = left;
-	quad[3].texCoords.y = bottom;
-}
\ No newline at end of file
+			if(outline.build(image, frame, trim.maxVertices))
+			{
+				m_frames.outlines[first + i] = outline;
+				isTraced[i] = 1;
+			}
+		}
+	};
+
+	if(trim.pool)
+		trim.pool->parallelFor(count, trace);
+	else
+		trace(0U, 0U, count);
+
+	bool result = true;
+
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		const auto& outline = m_frames.outlines[first + i];
+
+		statistics.frames        += 1U;
+		statistics.polygons      += outline.count > 4U ? 1U : 0U;
+		statistics.quadPixels    += std::uint64_t(m_frames.widths[first + i]) * m_frames.heights[first + i];
+		statistics.outlinePixels += outline.area;
+
+		result = isTraced[i] && result;
+	}
+
+	if(!result)
+		std::cerr << "Error: some frames do not fit the image they are trimmed against\n";
+
+	return result;
+}
+
+void SpriteManager::FrameArena::reserve(std::size_t count) noexcept
+{
+	textures.reserve(count);
+	firstVertices.reserve(count);
+	widths.reserve(count);
+	heights.reserve(count);
+	texCoords.reserve(count);
+	outlines.reserve(count);
+}
+
+std::uint32_t SpriteManager::FrameArena::getSize() const noexcept
+{
+	return static_cast<std::uint32_t>(textures.size());
+}
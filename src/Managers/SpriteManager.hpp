@@ -2,33 +2,81 @@
 #define SPRITE_MANAGER_HPP
 
 #include <string>
-#include <list>
+#include <vector>
+#include <utility>
 #include <unordered_map>
 #include <type_traits>
+#include <cstdint>
 
 #include <glm/glm.hpp>
 
 #include "system/NonCopyable.hpp"
+#include "system/StringId.hpp"
 #include "graphics/Vertex2D.hpp"
 #include "graphics/Animation.hpp"
+#include "graphics/Sprite2D.hpp"
+#include "graphics/SpriteOutline.hpp"
+#include "graphics/GrowableBuffer.hpp"
 
 class SpriteManager:
 	private NonCopyable
 {
 public:
-	using SpriteSheet = std::unordered_map<std::string, Animation>;
+	using SpriteSheet = std::unordered_map<StringId, Animation>;
+
+//	One entry per frame, std430 layout of SpriteFrames in sprite_frames.glsl
+	struct FrameData
+	{
+		glm::vec4     texCoords; // left, top, right, bottom
+		glm::vec2     size;      // In pixels
+		glm::vec2     padding;
+		std::uint32_t outline[SpriteOutline::MaxVertices]; // Points of the mesh, x | y << 16 in pixels
+	};
+
+	static constexpr unsigned FrameTableBinding = 1; // Shader storage binding of the frame table
+
+	struct UploadStatistics
+	{
+		std::uint32_t frames        = 0U; // Resident on the GPU
+		std::uint32_t capacity      = 0U; // Frames the buffers hold before they grow again
+		std::uint64_t uploadedBytes = 0U;
+		std::uint32_t reallocations = 0U;
+		std::uint64_t savedBytes    = 0U; // Against float vertices
+	};
+
+//	Fill rate of trimmed frames against their full quads
+	struct TrimStatistics
+	{
+		std::uint32_t frames        = 0U;
+		std::uint32_t polygons      = 0U; // Frames drawn with more than four vertices
+		std::uint64_t quadPixels    = 0U;
+		std::uint64_t outlinePixels = 0U;
+	};
+
+//	Replaces the quads of the frames being loaded with convex polygons of up to maxVertices corners around their
+//	visible pixels. The image is the one the texture was made from, e.g. given to AssetManager::get<Texture2D>,
+//	so the file is decoded once. The outlines are traced in parallel on the pool, if there is one
+	struct TrimOptions
+	{
+		const class Image* image       = nullptr;
+		class ThreadPool*  pool        = nullptr;
+		unsigned           maxVertices = SpriteOutline::MaxVertices;
+	};
 
 public:
 	SpriteManager() noexcept;
 	~SpriteManager();
 
-	bool createFrame(const std::string& name, const class Texture2D* texture, const glm::ivec4& frame) noexcept;
-	bool createLinearAnimaton(const std::string& name, const class Texture2D* texture, int duration, int delay) noexcept;
-	bool createGridAnimaton(const std::string& name, const class Texture2D* texture, int columns, int rows, int delay) noexcept;
-	bool loadSpriteSheet(const std::string& filename, const class Texture2D* texture) noexcept;
+	bool createFrame(const StringId& name, const class Texture2D* texture, const glm::ivec4& frame) noexcept;
+	bool createLinearAnimaton(const StringId& name, const class Texture2D* texture, int duration, int delay, const TrimOptions* trim = nullptr) noexcept;
+	bool createGridAnimaton(const StringId& name, const class Texture2D* texture, int columns, int rows, int delay, const TrimOptions* trim = nullptr) noexcept;
+	bool loadSpriteSheet(const StringId& filename, const class Texture2D* texture, const TrimOptions* trim = nullptr) noexcept;
+
+//	Pairs of (sprite sheet, texture file name). All textures are loaded together before the sheets are parsed
+	bool loadSpriteSheets(const std::vector<std::pair<StringId, StringId>>& sheets) noexcept;
 
 	template<class T>
-	const T* get(const std::string& name) const noexcept
+	const T* get(const StringId& name) const noexcept
 	{
 		if constexpr (std::is_same<T, Animation>::value)
 		{
@@ -36,7 +84,7 @@ public:
 			
 			return (found != m_animations.end()) ? &found->second : nullptr;
 		}
-		else if constexpr (std::is_same<T, std::unordered_map<std::string, Animation>>::value)
+		else if constexpr (std::is_same<T, SpriteSheet>::value)
 		{
 			auto found = m_spriteSheets.find(name);
 
@@ -46,23 +94,54 @@ public:
 		return nullptr;
 	}
 
+//	Of the animation or sprite sheet loaded with trimming under this name, nullptr if it was not trimmed
+	const TrimStatistics* getTrimStatistics(const StringId& name) const noexcept;
+
+//	Uploads the meshes and frame table entries added since the last call; the buffers only ever grow,
+//	so sprites already handed out stay valid and new sheets can be streamed in while a level runs.
+//	The frame table is attached to FrameTableBinding
 	void unloadOnGPU() noexcept;
 	void bind(bool on) noexcept;
 	void reset()       noexcept;
 	void draw(const Sprite2D& sprite) const noexcept;
 
+//	Frames are addressed by index: Animation::first + frame. An index out of range gives a sprite without texture
+	Sprite2D    getSprite(std::uint32_t index) const noexcept;
+	std::size_t getFrameCount() const noexcept;
+
+	UploadStatistics getUploadStatistics() const noexcept;
+
+	static std::uint32_t getFrameIndex(const Sprite2D& sprite) noexcept; // Into the frame table
+
 private:
-	void createSpriteFromFrame(const glm::ivec4& frame, const glm::vec2& ratio, std::vector<Sprite2D>& sprites, std::uint32_t texture) noexcept;
+//	Every frame of every animation, one array per field. Frames are only appended, so indices stay valid
+	struct FrameArena
+	{
+		std::vector<unsigned>      textures;
+		std::vector<unsigned>      firstVertices; // Of the frame's mesh in the vertex buffer, assigned on upload
+		std::vector<unsigned>      widths;
+		std::vector<unsigned>      heights;
+		std::vector<glm::vec4>     texCoords; // left, top, right, bottom
+		std::vector<SpriteOutline> outlines;  // The full quad unless the frame was trimmed
+
+		void          reserve(std::size_t count) noexcept;
+		std::uint32_t getSize() const noexcept;
+	};
+
+	void createSpriteFromFrame(const glm::ivec4& frame, const glm::vec2& ratio, std::uint32_t texture) noexcept;
+	bool trimFrames(const Animation& animation, const class Texture2D& texture, const TrimOptions& trim, TrimStatistics& statistics) noexcept;
 
 private:
-	std::unordered_map<std::string, Animation>   m_animations;
-	std::unordered_map<std::string, SpriteSheet> m_spriteSheets;
+	std::unordered_map<StringId, Animation>      m_animations;
+	std::unordered_map<StringId, SpriteSheet>    m_spriteSheets;
+	std::unordered_map<StringId, TrimStatistics> m_trimStatistics;
 
-	std::vector<Vertex2D>            m_vertexBuffer;
-	std::list<std::vector<Sprite2D>> m_sprites;
+	FrameArena m_frames;
 
-	unsigned m_vao;
-	unsigned m_vbo;
+	GrowableBuffer m_vertices;
+	GrowableBuffer m_frameTable;
+	std::uint32_t  m_uploadedFrames;
+	unsigned       m_vao;
 };
 
 #endif
\ No newline at end of file
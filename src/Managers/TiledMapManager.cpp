@@ -3,8 +3,11 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <climits>
 
-#include "rapidxml_utils.hpp"
+#include "rapidxml.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -12,31 +15,48 @@
 #include "system/FileProvider.hpp"
 #include "managers/AssetManager.hpp"
 #include "graphics/TiledMap.hpp"
+#include "graphics/RenderQueue.hpp"
+#include "graphics/PackedVertex2D.hpp"
 #include "managers/TiledMapManager.hpp"
 
-TiledMapManager::TiledMapManager() noexcept
+namespace
+{
+	constexpr std::uint32_t FlipFlags = 0xE0000000U; // Set on flipped and rotated tiles, ignored
+}
+
+TiledMapManager::TiledMapManager() noexcept:
+	m_emptyVao(0U),
+	m_view(0.0f),
+	m_hasView(false)
 {
 }
 
 TiledMapManager::~TiledMapManager()
 {
+	clear();
+
+	if (m_emptyVao)
+		glDeleteVertexArrays(1, &m_emptyVao);
 }
 
-const TiledMap* TiledMapManager::loadFromFile(const std::string& filename) noexcept
+const TiledMap* TiledMapManager::loadFromFile(const StringId& filename) noexcept
 {
 	const auto loaded = get(filename);
 	
 	if(loaded)
 		return loaded;
 
-	const std::string filepath = FileProvider().getPathToFile(filename);
+	const FileView file = FileProvider().getFileView(filename.c_str());
 
-	if(filepath.empty())
+	if(file.empty())
 		return nullptr;
 
+//	rapidxml parses in situ, so it gets a writable, null-terminated copy of the mapped bytes
+	std::vector<char> xmlText(file.data(), file.data() + file.size());
+	xmlText.push_back('\0');
+
 	auto document = std::make_unique<rapidxml::xml_document<char>>();
-	rapidxml::file<char> xmlFile(filepath.c_str());
-	document->parse<0>(xmlFile.data());
+	document->parse<0>(xmlText.data());
 	const rapidxml::xml_node<char>* mapNode = document->first_node("map");
 
 	if( ! mapNode )
@@ -48,12 +68,13 @@ const TiledMap* TiledMapManager::loadFromFile(const std::string& filename) noexc
 	if ( loadTileLayers(mapNode) && loadObjects(mapNode) )
 		return tiledMap.get();
 
+	destroy(*tiledMap);
 	m_tiledMaps.pop_back();
 
 	return nullptr;
 }
 
-const TiledMap* TiledMapManager::get(const std::string& filename) noexcept
+const TiledMap* TiledMapManager::get(const StringId& filename) noexcept
 {
 	for(const auto& tilemap : m_tiledMaps)
 		if(tilemap->m_name == filename)
@@ -62,22 +83,116 @@ const TiledMap* TiledMapManager::get(const std::string& filename) noexcept
     return nullptr;
 }
 
-void TiledMapManager::draw(const TiledMap::Layer& layer) const noexcept
+void TiledMapManager::setView(const glm::mat4& viewProjection) noexcept
 {
+	m_statistics = m_frame;
+	m_frame      = Statistics();
+
+//	The corners of the clip space brought back onto the map: their bounding box covers the screen, rotated views included
+	const glm::mat4 inverse = glm::inverse(viewProjection);
+	const float     corners[4][2] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+
+	m_view = glm::vec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+	for (const auto& corner : corners)
+	{
+		const glm::vec4 point = inverse * glm::vec4(corner[0], corner[1], 0.0f, 1.0f);
+		const float     x     = point.x / point.w;
+		const float     y     = point.y / point.w;
+
+		m_view = glm::vec4(std::min(m_view.x, x), std::min(m_view.y, y), std::max(m_view.z, x), std::max(m_view.w, y));
+	}
+
+	m_hasView = true;
+}
+
+void TiledMapManager::draw(const TiledMap::Layer& layer) noexcept
+{
+	cull(layer);
+
+	if (m_ranges.empty())
+		return;
+
 	glBindTexture(GL_TEXTURE_2D, layer.texture);
 	glBindVertexArray(layer.vao);
 
-	glDrawElements(GL_TRIANGLES, layer.count, GL_UNSIGNED_INT, nullptr);
+	for (const auto& range : m_ranges)
+		glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, range.count * 6u, GL_UNSIGNED_SHORT, nullptr, 1, range.first * 4u, TiledMap::packTileSize(layer.tileSize));
 	
 	glBindVertexArray(0);
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+void TiledMapManager::submit(const TiledMap::Layer& layer, const Shader* shader, RenderQueue& queue, std::uint8_t renderLayer, std::uint16_t depth) noexcept
+{
+	cull(layer);
+
+	for (const auto& range : m_ranges)
+	{
+		DrawPacket packet;
+		packet.shader       = shader;
+		packet.texture      = layer.texture;
+		packet.vao          = layer.vao;
+		packet.mode         = GL_TRIANGLES;
+		packet.count        = range.count * 6u;
+		packet.indexType    = GL_UNSIGNED_SHORT;
+		packet.baseVertex   = static_cast<int>(range.first * 4u);
+		packet.baseInstance = TiledMap::packTileSize(layer.tileSize);
+
+		queue.submit(packet, renderLayer, depth);
+	}
+}
+
+void TiledMapManager::drawTileIndices(const TiledMap::Layer& layer) noexcept
+{
+	if (!layer.indexTexture || !isVisible(layer))
+		return;
+
+	glBindTexture(GL_TEXTURE_2D, layer.texture);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, layer.indexTexture);
+	glActiveTexture(GL_TEXTURE0);
+	glBindVertexArray(m_emptyVao);
+
+	glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4, 1, TiledMap::packTileSize(layer.tileSize));
+
+	glBindVertexArray(0);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void TiledMapManager::submitTileIndices(const TiledMap::Layer& layer, const Shader* shader, RenderQueue& queue, std::uint8_t renderLayer, std::uint16_t depth) noexcept
+{
+	if (!layer.indexTexture || !isVisible(layer))
+		return;
+
+	DrawPacket packet;
+	packet.shader       = shader;
+	packet.texture      = layer.texture;
+	packet.texture1     = layer.indexTexture;
+	packet.vao          = m_emptyVao;
+	packet.mode         = GL_TRIANGLE_STRIP;
+	packet.count        = 4U;
+	packet.baseInstance = TiledMap::packTileSize(layer.tileSize);
+
+	queue.submit(packet, renderLayer, depth);
+}
+
 void TiledMapManager::clear() noexcept
 {
+	for (const auto& tiledMap : m_tiledMaps)
+		destroy(*tiledMap);
+
 	m_tiledMaps.clear();
 }
 
+const TiledMapManager::Statistics& TiledMapManager::getStatistics() const noexcept
+{
+	return m_statistics;
+}
+
 bool TiledMapManager::loadTileLayers(const rapidxml::xml_node<char>* mapNode) noexcept
 {
 	std::vector<TilesetData> tilesets = parseTilesets(mapNode);
@@ -95,6 +210,22 @@ bool TiledMapManager::loadTileLayers(const rapidxml::xml_node<char>* mapNode) no
 	const int tile_width  = tileW ? std::atoi(tileW->value()) : 0;
 	const int tile_height = tileH ? std::atoi(tileH->value()) : 0;
 
+//	Tile corners are stored as 16-bit tile coordinates
+	if (map_width >= UINT16_MAX || map_height >= UINT16_MAX)
+	{
+		std::cerr << "Error: a map of " << map_width << 'x' << map_height << " tiles is larger than the packed vertices can address\n";
+
+		return false;
+	}
+
+//	The tile size travels in the base instance of the draws, 16 bits a side
+	if (tile_width <= 0 || tile_height <= 0 || tile_width > UINT16_MAX || tile_height > UINT16_MAX)
+	{
+		std::cerr << "Error: tiles of " << tile_width << 'x' << tile_height << " pixels are not supported\n";
+
+		return false;
+	}
+
 	auto tiledMap = m_tiledMaps.back().get();
 
 	tiledMap->m_mapSize  = { map_width, map_height };
@@ -115,14 +246,17 @@ bool TiledMapManager::loadTileLayers(const rapidxml::xml_node<char>* mapNode) no
 		if (!dataNode)
 			continue;
 
-		std::vector<int> parsed_layer = parseCSVstring(dataNode);
+		std::vector<std::uint32_t> parsed_layer = parseCSVstring(dataNode);
+
+		if (parsed_layer.empty())
+			continue;
 
 		std::size_t non_zero_tile_count = std::count_if(parsed_layer.begin(), parsed_layer.end(),
-			[](int n) { return n > 0; });
+			[](std::uint32_t n) { return n > 0U; });
 
 		const auto bounds = std::minmax_element(parsed_layer.begin(), parsed_layer.end());
-		int minTile = *bounds.first;
-		int maxTile = *bounds.second;
+		int minTile = static_cast<int>(*bounds.first); // Masked, they fit an int
+		int maxTile = static_cast<int>(*bounds.second);
 
 		auto currentTileset = std::find_if(tilesets.begin(), tilesets.end(),
 		[minTile, maxTile](const TilesetData& ts)
@@ -136,57 +270,76 @@ bool TiledMapManager::loadTileLayers(const rapidxml::xml_node<char>* mapNode) no
 		auto& layer = tiledMap->m_layers.emplace_back();
 		layer.name = name;
 		layer.texture = currentTileset->texture->getNativeHandle();
+		layer.tileSize = tiledMap->m_tileSize;
 
-		std::vector<Vertex2D> vertices;
-		std::vector<unsigned> indices;
-
+		std::vector<PackedVertex2D> vertices;
 		vertices.reserve(non_zero_tile_count * 4);
-		indices.reserve(non_zero_tile_count * 6);
 
 		auto ratio = 1.0f / glm::vec2(currentTileset->texture->getSize());
 
-		for (int y = 0u; y < map_height; ++y)
-			for (int x = 0u; x < map_width; ++x)
-			{
-				int tile_id = parsed_layer[y * map_width + x];
+		const int chunkSize = static_cast<int>(TiledMap::ChunkSize);
 
-				if (tile_id)
-				{
-					int tile_num = tile_id - currentTileset->firstGID;
+		layer.chunkColumns = static_cast<unsigned>((map_width  + chunkSize - 1) / chunkSize);
+		layer.chunkRows    = static_cast<unsigned>((map_height + chunkSize - 1) / chunkSize);
+		layer.chunkExtent  = glm::vec2(static_cast<float>(chunkSize * tile_width), static_cast<float>(chunkSize * tile_height));
+		layer.chunks.resize(layer.chunkColumns * layer.chunkRows);
 
-					int Y = (tile_num >= currentTileset->columns) ? tile_num / currentTileset->columns : 0u;
-					int X = tile_num % currentTileset->columns;
-
-					int offsetX = X * tile_width;
-					int offsetY = Y * tile_height;
-
-					float left   = offsetX * ratio.x;
-					float top    = offsetY * ratio.y;
-					float right  = (offsetX + tile_width) * ratio.x;
-					float bottom = (offsetY + tile_height) * ratio.y;
-
-					glm::vec2 leftBottom  = { x * tile_width,              y * tile_height + tile_height };
-					glm::vec2 rightBootom = { x * tile_width + tile_width, y * tile_height + tile_height };
-					glm::vec2 rightTop    = { x * tile_width + tile_width, y * tile_height };
-					glm::vec2 leftTop     = { x * tile_width,              y * tile_height };
+//		Chunk by chunk, so the quads of a chunk are contiguous and a row of chunks is too
+		for (int chunkY = 0; chunkY < static_cast<int>(layer.chunkRows); ++chunkY)
+			for (int chunkX = 0; chunkX < static_cast<int>(layer.chunkColumns); ++chunkX)
+			{
+				auto& chunk = layer.chunks[chunkY * layer.chunkColumns + chunkX];
+				chunk.first = static_cast<unsigned>(vertices.size() / 4u);
 
-					unsigned index = static_cast<unsigned>(vertices.size());
+				glm::ivec4 covered(INT_MAX, INT_MAX, INT_MIN, INT_MIN);
 
-					vertices.emplace_back(leftBottom.x, leftBottom.y, left, bottom);
-					vertices.emplace_back(rightBootom.x, rightBootom.y, right, bottom);
-					vertices.emplace_back(rightTop.x, rightTop.y, right, top);
-					vertices.emplace_back(leftTop.x, leftTop.y, left, top);
+				for (int y = chunkY * chunkSize; y < std::min((chunkY + 1) * chunkSize, map_height); ++y)
+					for (int x = chunkX * chunkSize; x < std::min((chunkX + 1) * chunkSize, map_width); ++x)
+					{
+						int tile_id  = static_cast<int>(parsed_layer[y * map_width + x]);
+						int tile_num = tile_id - currentTileset->firstGID;
+
+//						Empty, or of another tileset: left out, as createTileIndices does
+						if (tile_id && tile_num >= 0 && tile_num < currentTileset->tileCount)
+						{
+							covered = glm::ivec4(std::min(covered.x, x), std::min(covered.y, y), std::max(covered.z, x + 1), std::max(covered.w, y + 1));
+
+							int Y = (tile_num >= currentTileset->columns) ? tile_num / currentTileset->columns : 0u;
+							int X = tile_num % currentTileset->columns;
+
+							int offsetX = X * tile_width;
+							int offsetY = Y * tile_height;
+
+							float left   = offsetX * ratio.x;
+							float top    = offsetY * ratio.y;
+							float right  = (offsetX + tile_width) * ratio.x;
+							float bottom = (offsetY + tile_height) * ratio.y;
+
+//							In tiles: tilemap.vert scales them by the tile size of the draw
+							const auto tileLeft   = static_cast<std::uint16_t>(x);
+							const auto tileTop    = static_cast<std::uint16_t>(y);
+							const auto tileRight  = static_cast<std::uint16_t>(x + 1);
+							const auto tileBottom = static_cast<std::uint16_t>(y + 1);
+
+							vertices.emplace_back(tileLeft,  tileBottom, left,  bottom);
+							vertices.emplace_back(tileRight, tileBottom, right, bottom);
+							vertices.emplace_back(tileRight, tileTop,    right, top);
+							vertices.emplace_back(tileLeft,  tileTop,    left,  top);
+						}
+					}
 
-					indices.push_back(index);
-					indices.push_back(index + 1u);
-					indices.push_back(index + 2u);
+				chunk.count = static_cast<unsigned>(vertices.size() / 4u) - chunk.first;
 
-					indices.push_back(index);
-					indices.push_back(index + 2u);
-					indices.push_back(index + 3u);
+				if (chunk.count)
+				{
+					chunk.bounds = glm::vec4(static_cast<float>(covered.x * tile_width), static_cast<float>(covered.y * tile_height),
+					                         static_cast<float>(covered.z * tile_width), static_cast<float>(covered.w * tile_height));
+					++layer.filledChunks;
 				}
 			}
-		unloadOnGPU(vertices, indices);
+
+		unloadOnGPU(vertices);
+		createTileIndices(parsed_layer, *currentTileset);
 	}
 
 	return true;
@@ -242,13 +395,19 @@ bool TiledMapManager::loadObjects(const rapidxml::xml_node<char>* mapNode) noexc
 std::vector<TiledMapManager::TilesetData> TiledMapManager::parseTilesets(const rapidxml::xml_node<char>* mapNode) noexcept
 {
 	std::vector<TilesetData> tilesets;
+	std::vector<const rapidxml::xml_node<char>*> tilesetNodes;
+	std::vector<Texture2D*> textures;
 
+//	The map holds its tilesets, so they become evictable once the map is cleared
+	auto& handles = m_tiledMaps.back()->m_tilesets;
+
+//	Request every tileset texture first, so they are decoded in parallel
 	for (auto tilesetNode = mapNode->first_node("tileset");
 		      tilesetNode != nullptr;
 		      tilesetNode = tilesetNode->next_sibling("tileset"))
 	{
 		auto imageNode = tilesetNode->first_node("image");
-		auto sourceNode = imageNode->first_attribute("source");
+		auto sourceNode = imageNode ? imageNode->first_attribute("source") : nullptr;
 
 		std::string texName = sourceNode ? sourceNode->value() : std::string();
 
@@ -260,9 +419,22 @@ std::vector<TiledMapManager::TilesetData> TiledMapManager::parseTilesets(const r
 		if (last_slash_pos != std::string::npos)	
 			texName.erase(0, last_slash_pos + 1);
 		
-		auto tileset = AssetManager::get<Texture2D>(texName);
+		if (auto texture = AssetManager::acquireAsync<Texture2D>(texName); texture)
+		{
+			tilesetNodes.push_back(tilesetNode);
+			textures.push_back(texture.get());
+			handles.push_back(std::move(texture));
+		}
+	}
+
+	AssetManager::wait(textures);
 
-		if( tileset == nullptr )
+	for (std::size_t i = 0; i < tilesetNodes.size(); ++i)
+	{
+		auto tilesetNode = tilesetNodes[i];
+		auto tileset     = textures[i];
+
+		if ( ! tileset->isResident() )
 			continue;
 
 		TilesetData& ts = tilesets.emplace_back();
@@ -281,52 +453,204 @@ std::vector<TiledMapManager::TilesetData> TiledMapManager::parseTilesets(const r
 	return tilesets;
 }
 
-std::vector<int> TiledMapManager::parseCSVstring(const rapidxml::xml_node<char>* dataNode) noexcept
+// The GIDs are unsigned: the flip flags take their top three bits. They are dropped here, once, so the mesh
+// and the index texture see the same tiles
+std::vector<std::uint32_t> TiledMapManager::parseCSVstring(const rapidxml::xml_node<char>* dataNode) noexcept
 {
 	std::string data(dataNode->value());
 
 	std::size_t amount = std::count_if(data.begin(), data.end(), [](char c){ return c == ','; }) + 1;
 	std::replace(data.begin(), data.end(), ',', ' ');
 
-	std::vector<int> parsed_layer;
+	std::vector<std::uint32_t> parsed_layer;
 	parsed_layer.reserve(amount);
 
 	std::stringstream sstream(data);
 	{
-		int tile_num = 0;
+		std::uint32_t tile_num = 0U;
 
 		while (sstream >> tile_num)
-			parsed_layer.push_back(tile_num);
+			parsed_layer.push_back(tile_num & ~FlipFlags);
 	}
 
 	return parsed_layer;
 }
 
-void TiledMapManager::unloadOnGPU(const std::vector<Vertex2D>& vertices, const std::vector<unsigned>& indices) noexcept
+void TiledMapManager::unloadOnGPU(const std::vector<PackedVertex2D>& vertices) noexcept
 {
-	if(m_tiledMaps.empty())
+	if(m_tiledMaps.empty() || !m_quadIndices.create())
 		return;
 
-	auto& layer = m_tiledMaps.back()->m_layers.back();
-	layer.count = indices.size();
+	auto& tiledMap = *m_tiledMaps.back();
+	auto& layer    = tiledMap.m_layers.back();
+	layer.count    = static_cast<unsigned>(vertices.size() / 4u * 6u);
+
+//	Float vertices and 32-bit indices would have taken 88 bytes per tile, the packed vertices take 32
+	const std::size_t tiles = vertices.size() / 4u;
+	tiledMap.m_memory.vertexBytes += sizeof(PackedVertex2D) * vertices.size();
+	tiledMap.m_memory.savedBytes  += tiles * (4u * sizeof(Vertex2D) + 6u * sizeof(std::uint32_t)) - sizeof(PackedVertex2D) * vertices.size();
 
 	glGenVertexArrays(1, &layer.vao);
 	glGenBuffers(1, &layer.vbo);
-	glGenBuffers(1, &layer.ebo);
 
 	glBindVertexArray(layer.vao);
 
 	glBindBuffer(GL_ARRAY_BUFFER, layer.vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex2D) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex2D) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
 
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), nullptr);
+	glVertexAttribPointer(0, 2, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(PackedVertex2D), nullptr);
 	glEnableVertexAttribArray(0);
 
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), (void*)offsetof(Vertex2D, texCoords));
+	glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex2D), (void*)offsetof(PackedVertex2D, texCoords));
 	glEnableVertexAttribArray(1);
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, layer.ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned) * indices.size(), indices.data(), GL_STATIC_DRAW);
+	m_quadIndices.bind();
 
 	glBindVertexArray(0);
-}
\ No newline at end of file
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TiledMapManager::createTileIndices(const std::vector<std::uint32_t>& tiles, const TilesetData& tileset) noexcept
+{
+	auto& tiledMap = *m_tiledMaps.back();
+	auto& layer    = tiledMap.m_layers.back();
+
+	const auto width  = static_cast<GLsizei>(tiledMap.m_mapSize.x);
+	const auto height = static_cast<GLsizei>(tiledMap.m_mapSize.y);
+
+	if (tiles.size() < static_cast<std::size_t>(width) * height || !width || !height)
+		return;
+
+	if (!m_emptyVao)
+		glGenVertexArrays(1, &m_emptyVao);
+
+//	Relative to the tileset of the layer, so 16 bits are enough unless the tileset itself is that large.
+//	The tiles of other tilesets are left empty
+	std::vector<std::uint32_t> indices(tiles.size());
+
+	const auto firstGID  = static_cast<std::uint32_t>(std::max(tileset.firstGID, 0));
+	const auto tileCount = static_cast<std::uint32_t>(std::max(tileset.tileCount, 0));
+
+	for (std::size_t i = 0; i < tiles.size(); ++i)
+	{
+		const std::uint32_t tile = tiles[i];
+
+		indices[i] = (tile >= firstGID && tile - firstGID < tileCount) ? tile - firstGID + 1U : 0U;
+	}
+
+	const bool isWide = tileset.tileCount >= UINT16_MAX;
+
+	glGenTextures(1, &layer.indexTexture);
+	glBindTexture(GL_TEXTURE_2D, layer.indexTexture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, isWide ? 4 : 2);
+
+	if (isWide)
+	{
+		glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32UI, width, height);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED_INTEGER, GL_UNSIGNED_INT, indices.data());
+	}
+	else
+	{
+		const std::vector<std::uint16_t> narrow(indices.begin(), indices.end());
+
+		glTexStorage2D(GL_TEXTURE_2D, 1, GL_R16UI, width, height);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED_INTEGER, GL_UNSIGNED_SHORT, narrow.data());
+	}
+
+//	Integer textures are only complete with nearest filtering
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	tiledMap.m_memory.indexBytes += static_cast<std::size_t>(width) * height * (isWide ? 4U : 2U);
+}
+
+void TiledMapManager::destroy(TiledMap& tiledMap) noexcept
+{
+	for (auto& layer : tiledMap.m_layers)
+	{
+		if (layer.vao)
+			glDeleteVertexArrays(1, &layer.vao);
+
+		if (layer.vbo)
+			glDeleteBuffers(1, &layer.vbo);
+
+		if (layer.indexTexture)
+			glDeleteTextures(1, &layer.indexTexture);
+
+		layer.vao          = 0U;
+		layer.vbo          = 0U;
+		layer.indexTexture = 0U;
+	}
+}
+
+bool TiledMapManager::isVisible(const TiledMap::Layer& layer) const noexcept
+{
+	if (!m_hasView)
+		return true;
+
+	const float right  = layer.chunkColumns * layer.chunkExtent.x;
+	const float bottom = layer.chunkRows    * layer.chunkExtent.y;
+
+	return m_view.x < right && m_view.z > 0.0f && m_view.y < bottom && m_view.w > 0.0f;
+}
+
+void TiledMapManager::cull(const TiledMap::Layer& layer) noexcept
+{
+	m_ranges.clear();
+
+	if (layer.chunks.empty())
+		return;
+
+	unsigned firstColumn = 0U;
+	unsigned lastColumn  = layer.chunkColumns;
+	unsigned firstRow    = 0U;
+	unsigned lastRow     = layer.chunkRows;
+
+//	Only the cells of the chunk grid under the view are visited
+	if (m_hasView)
+	{
+		auto toCell = [](float position, float extent, unsigned cells)
+		{
+			return static_cast<unsigned>(std::clamp(std::floor(position / extent), 0.0f, static_cast<float>(cells)));
+		};
+
+		firstColumn = toCell(m_view.x, layer.chunkExtent.x, layer.chunkColumns);
+		lastColumn  = toCell(m_view.z, layer.chunkExtent.x, layer.chunkColumns - 1U) + 1U;
+		firstRow    = toCell(m_view.y, layer.chunkExtent.y, layer.chunkRows);
+		lastRow     = toCell(m_view.w, layer.chunkExtent.y, layer.chunkRows - 1U) + 1U;
+	}
+
+	unsigned visibleChunks = 0U;
+	unsigned visibleQuads  = 0U;
+
+	for (unsigned row = firstRow; row < lastRow; ++row)
+		for (unsigned column = firstColumn; column < lastColumn; ++column)
+		{
+			const auto& chunk = layer.chunks[row * layer.chunkColumns + column];
+
+			if (!chunk.count)
+				continue;
+
+			if (m_hasView && (chunk.bounds.x >= m_view.z || chunk.bounds.z <= m_view.x || chunk.bounds.y >= m_view.w || chunk.bounds.w <= m_view.y))
+				continue;
+
+			++visibleChunks;
+			visibleQuads += chunk.count;
+
+//			Neighbours in the buffer are drawn together, up to what the 16-bit quad indices address
+			if (!m_ranges.empty() && m_ranges.back().first + m_ranges.back().count == chunk.first && m_ranges.back().count + chunk.count <= PolygonIndexBuffer::MaxQuads)
+				m_ranges.back().count += chunk.count;
+			else
+				m_ranges.push_back({ chunk.first, chunk.count });
+		}
+
+	m_frame.visibleChunks   += visibleChunks;
+	m_frame.culledChunks    += layer.filledChunks - visibleChunks;
+	m_frame.drawnTriangles  += visibleQuads * 2U;
+	m_frame.culledTriangles += (layer.count / 6U - visibleQuads) * 2U;
+}
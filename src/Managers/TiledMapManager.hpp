@@ -5,12 +5,22 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <cstdint>
+
+#include <glm/glm.hpp>
 
 #include "rapidxml.hpp"
 
 #include "system/NonCopyable.hpp"
+#include "system/StringId.hpp"
 #include "graphics/Vertex2D.hpp"
+#include "graphics/PolygonIndexBuffer.hpp"
 
+// Layers are split into chunks of TiledMap::ChunkSize tiles. Once a view is set, draw and submit only issue
+// the chunks whose bounds intersect it, merging neighbours of a row into one call, so the cost follows
+// the screen area rather than the map area.
+// Every layer also gets a tile index texture: drawTileIndices and submitTileIndices draw it as one quad
+// whose fragments look their tile up, for a few bytes per tile and a cost bound by the screen, not the map
 class TiledMapManager:
 	private NonCopyable
 {
@@ -24,14 +34,42 @@ private:
 		int firstGID  = 1;
 	};
 
+//	Quads of consecutive visible chunks
+	struct Range
+	{
+		unsigned first = 0U;
+		unsigned count = 0U;
+	};
+
+public:
+	struct Statistics
+	{
+		std::uint32_t visibleChunks   = 0U;
+		std::uint32_t culledChunks    = 0U; // Chunks with tiles outside the view
+		std::uint32_t drawnTriangles  = 0U;
+		std::uint32_t culledTriangles = 0U;
+	};
+
 public:
 	TiledMapManager() noexcept;
 	~TiledMapManager();
 
-	const struct TiledMap* loadFromFile(const std::string& filename) noexcept;
-	const struct TiledMap* get(const std::string& filename) noexcept;
-	void draw(const TiledMap::Layer& layer) const noexcept;
+	const struct TiledMap* loadFromFile(const StringId& filename) noexcept;
+	const struct TiledMap* get(const StringId& filename) noexcept;
+
+//	The draws and submits that follow are culled against the view-projection, and the statistics of the
+//	previous view are closed. Until a view is set every chunk is drawn
+	void setView(const glm::mat4& viewProjection) noexcept;
+
+	void draw(const TiledMap::Layer& layer) noexcept;
+	void submit(const TiledMap::Layer& layer, const class Shader* shader, class RenderQueue& queue, std::uint8_t renderLayer, std::uint16_t depth) noexcept;
+
+//	For tilemap_indices.vert and tilemap_indices.frag, skipped when the view misses the layer
+	void drawTileIndices(const TiledMap::Layer& layer) noexcept;
+	void submitTileIndices(const TiledMap::Layer& layer, const class Shader* shader, class RenderQueue& queue, std::uint8_t renderLayer, std::uint16_t depth) noexcept;
 	void clear() noexcept;
+
+	const Statistics& getStatistics() const noexcept; // Of the previous view
 	
 private:
 	bool loadTileLayers(const rapidxml::xml_node<char>* mapNode) noexcept;
@@ -39,12 +77,25 @@ private:
 
 private:
 	std::vector<TilesetData>  parseTilesets(const rapidxml::xml_node<char>* mapNode)   noexcept;
-	std::vector<int> parseCSVstring(const rapidxml::xml_node<char>* dataNode) noexcept;
+	std::vector<std::uint32_t> parseCSVstring(const rapidxml::xml_node<char>* dataNode) noexcept;
 
-	void unloadOnGPU(const std::vector<Vertex2D>& vertices, const std::vector<std::uint32_t>& indices) noexcept;
+	void unloadOnGPU(const std::vector<struct PackedVertex2D>& vertices) noexcept;
+	void createTileIndices(const std::vector<std::uint32_t>& tiles, const TilesetData& tileset) noexcept;
+	void destroy(TiledMap& tiledMap) noexcept; // Deletes what its layers hold on the GPU
+	bool isVisible(const TiledMap::Layer& layer) const noexcept;
+	void cull(const TiledMap::Layer& layer) noexcept;
 
 private:
 	std::vector<std::unique_ptr<TiledMap>> m_tiledMaps;
+	PolygonIndexBuffer                     m_quadIndices; // Shared by every layer
+	unsigned                               m_emptyVao;    // For the attributeless quads of the tile index textures
+
+	std::vector<Range> m_ranges;  // Of the layer being drawn
+	glm::vec4          m_view;    // Visible area in pixels: left, top, right, bottom
+	bool               m_hasView;
+
+	Statistics m_frame;
+	Statistics m_statistics;
 };
 
 #endif // !TILED_MAP_MANAGER_HPP
@@ -0,0 +1,683 @@
+#include <glad/glad.h>
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+
+#include "rapidxml.hpp"
+
+#include "system/ThreadPool.hpp"
+#include "system/FileProvider.hpp"
+#include "managers/AssetManager.hpp"
+#include "graphics/RenderQueue.hpp"
+#include "graphics/TiledMap.hpp"
+#include "managers/TiledMapStreamer.hpp"
+
+namespace
+{
+//	Value of name="..." inside a tag, empty if missing
+	std::string_view getAttribute(std::string_view tag, std::string_view name) noexcept
+	{
+		for (std::size_t found = tag.find(name); found != std::string_view::npos; found = tag.find(name, found + 1U))
+		{
+			const std::size_t quote = found + name.size();
+
+			if (found == 0U || tag[found - 1U] != ' ' || tag.substr(quote, 2U) != "=\"")
+				continue;
+
+			const std::size_t end = tag.find('"', quote + 2U);
+
+			return (end != std::string_view::npos) ? tag.substr(quote + 2U, end - quote - 2U) : std::string_view();
+		}
+
+		return std::string_view();
+	}
+
+	int getIntAttribute(std::string_view tag, std::string_view name) noexcept
+	{
+		const std::string value(getAttribute(tag, name));
+
+		return std::atoi(value.c_str());
+	}
+
+	bool intersects(const glm::vec4& a, const glm::vec4& b) noexcept
+	{
+		return a.x < b.z && a.z > b.x && a.y < b.w && a.w > b.y;
+	}
+
+	constexpr std::uint32_t FlipFlags = 0xE0000000U; // Set on flipped and rotated tiles, ignored
+}
+
+TiledMapStreamer::TiledMapStreamer(ThreadPool& pool) noexcept:
+	m_pool(pool),
+	m_cellSize(1, 1),
+	m_tileSize(0U, 0U),
+	m_view(0.0f),
+	m_frame(0U),
+	m_radius(0.0f),
+	m_shrunkView(0.0f),
+	m_inFlight(0U)
+{
+}
+
+TiledMapStreamer::~TiledMapStreamer()
+{
+	close();
+}
+
+bool TiledMapStreamer::open(const StringId& filename) noexcept
+{
+	return open(filename, Settings());
+}
+
+bool TiledMapStreamer::open(const StringId& filename, const Settings& settings) noexcept
+{
+	close();
+
+	m_file = FileProvider().getFileView(filename.c_str());
+
+	if (m_file.empty())
+		return false;
+
+	const char* begin = m_file.data();
+	const char* end   = begin + m_file.size();
+
+	const std::string_view text(begin, m_file.size());
+	const std::size_t      firstLayer = text.find("<layer");
+
+	if (firstLayer == std::string_view::npos || !m_quadIndices.create())
+	{
+		close();
+
+		return false;
+	}
+
+	m_settings = settings;
+
+	if (!loadTilesets(begin, begin + firstLayer) || !indexChunks(begin + firstLayer, end))
+	{
+		std::cerr << "Error: " << filename.c_str() << " is not a Tiled map in the infinite CSV format\n";
+		close();
+
+		return false;
+	}
+
+	m_radius     = m_settings.radius;
+	m_shrunkView = glm::vec4(0.0f);
+
+	m_statistics               = Statistics();
+	m_statistics.indexedChunks = static_cast<std::uint32_t>(m_chunks.size());
+	m_statistics.radius        = m_radius;
+
+	return true;
+}
+
+void TiledMapStreamer::close() noexcept
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_idle.wait(lock, [this] { return m_inFlight == 0U; });
+		m_meshes.clear();
+	}
+
+	for (const auto chunk : m_resident)
+		evict(chunk);
+
+	m_resident.clear();
+	m_chunks.clear();
+	m_cells.clear();
+	m_layers.clear();
+	m_tilesets.clear();
+	m_textures.clear();
+	m_file = FileView();
+}
+
+void TiledMapStreamer::update(const glm::mat4& viewProjection) noexcept
+{
+	if (m_chunks.empty())
+		return;
+
+	++m_frame;
+
+//	The corners of the clip space brought back onto the map, as in TiledMapManager::setView
+	const glm::mat4 inverse = glm::inverse(viewProjection);
+	const float     corners[4][2] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+
+	m_view = glm::vec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+	for (const auto& corner : corners)
+	{
+		const glm::vec4 point = inverse * glm::vec4(corner[0], corner[1], 0.0f, 1.0f);
+		const float     x     = point.x / point.w;
+		const float     y     = point.y / point.w;
+
+		m_view = glm::vec4(std::min(m_view.x, x), std::min(m_view.y, y), std::max(m_view.z, x), std::max(m_view.w, y));
+	}
+
+//	Once the view moved away from where the budget was hit, the reach grows back a cell at a time,
+//	only while the budget is comfortably met
+	if (m_radius < m_settings.radius && m_view != m_shrunkView && m_statistics.residentBytes < m_settings.memoryBudget / 4U * 3U)
+	{
+		const float step = static_cast<float>(std::max(m_cellSize.x * static_cast<int>(m_tileSize.x), m_cellSize.y * static_cast<int>(m_tileSize.y)));
+
+		m_radius = std::min(m_radius + step, m_settings.radius);
+	}
+
+	const float     radius = m_radius;
+	const glm::vec4 reach(m_view.x - radius, m_view.y - radius, m_view.z + radius, m_view.w + radius);
+	const float     centerX = (m_view.x + m_view.z) * 0.5f;
+	const float     centerY = (m_view.y + m_view.w) * 0.5f;
+
+	auto getDistance = [this, centerX, centerY](std::uint32_t chunk)
+	{
+		const glm::vec4& bounds = m_chunks[chunk].bounds;
+		const float      x      = (bounds.x + bounds.z) * 0.5f - centerX;
+		const float      y      = (bounds.y + bounds.w) * 0.5f - centerY;
+
+		return x * x + y * y;
+	};
+
+//	How far outside the view a chunk is, along the axis it is farthest on: it is within reach below the radius
+	auto getGap = [this](std::uint32_t chunk)
+	{
+		const glm::vec4& bounds = m_chunks[chunk].bounds;
+
+		return std::max(std::max(bounds.x - m_view.z, m_view.x - bounds.z), std::max(bounds.y - m_view.w, m_view.y - bounds.w));
+	};
+
+//	Every chunk within reach is marked, the missing ones are requested nearest first
+	m_candidates.clear();
+
+	forEachChunk(reach, [this, &reach](std::uint32_t chunk)
+	{
+		if (!intersects(m_chunks[chunk].bounds, reach))
+			return;
+
+		m_chunks[chunk].lastSeen = m_frame;
+
+		if (m_chunks[chunk].state == State::Unloaded)
+			m_candidates.push_back(chunk);
+	});
+
+	std::sort(m_candidates.begin(), m_candidates.end(), [&getDistance](std::uint32_t left, std::uint32_t right)
+	{
+		return getDistance(left) < getDistance(right);
+	});
+
+	for (const auto chunk : m_candidates)
+	{
+		if (m_statistics.pendingChunks >= m_settings.maxLoads)
+			break;
+
+//		What is off screen waits while the budget is spent
+		if (m_statistics.residentBytes >= m_settings.memoryBudget && !intersects(m_chunks[chunk].bounds, m_view))
+			continue;
+
+		const std::uint32_t request = ++m_chunks[chunk].request;
+		m_chunks[chunk].state = State::Loading;
+		++m_statistics.pendingChunks;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			++m_inFlight;
+		}
+
+		m_pool.push([this, chunk, request] { mesh(chunk, request); });
+	}
+
+//	A few meshes per frame reach the GPU; those of chunks that went out of reach meanwhile are dropped
+	std::vector<Mesh> meshes;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const std::size_t count = std::min<std::size_t>(m_meshes.size(), m_settings.maxUploads);
+		meshes.assign(std::make_move_iterator(m_meshes.begin()), std::make_move_iterator(m_meshes.begin() + static_cast<std::ptrdiff_t>(count)));
+		m_meshes.erase(m_meshes.begin(), m_meshes.begin() + static_cast<std::ptrdiff_t>(count));
+	}
+
+	for (auto& mesh : meshes)
+	{
+		--m_statistics.pendingChunks;
+
+		Chunk& chunk = m_chunks[mesh.chunk];
+
+		if (chunk.state != State::Loading || chunk.request != mesh.request)
+			continue;
+
+		if (chunk.lastSeen != m_frame)
+		{
+			chunk.state = State::Unloaded;
+
+			continue;
+		}
+
+		upload(mesh);
+		m_resident.push_back(mesh.chunk);
+	}
+
+//	Out of reach chunks go first, then the farthest ones off screen while the meshes exceed the budget.
+//	The reach then stops short of the evicted chunks, or they would be requested again at the next update
+	auto isOutOfReach = [this](std::uint32_t chunk)
+	{
+		if (m_chunks[chunk].lastSeen == m_frame)
+			return false;
+
+		evict(chunk);
+
+		return true;
+	};
+
+	m_resident.erase(std::remove_if(m_resident.begin(), m_resident.end(), isOutOfReach), m_resident.end());
+
+	if (m_statistics.residentBytes > m_settings.memoryBudget)
+	{
+		std::sort(m_resident.begin(), m_resident.end(), [&getGap](std::uint32_t left, std::uint32_t right)
+		{
+			return getGap(left) > getGap(right);
+		});
+
+		std::size_t first = 0U;
+
+		while (first < m_resident.size() && m_statistics.residentBytes > m_settings.memoryBudget && getGap(m_resident[first]) >= 0.0f)
+			evict(m_resident[first++]);
+
+		if (first > 0U)
+		{
+			m_radius     = std::min(m_radius, getGap(m_resident[first - 1U]));
+			m_shrunkView = m_view;
+		}
+
+		m_resident.erase(m_resident.begin(), m_resident.begin() + static_cast<std::ptrdiff_t>(first));
+	}
+
+	m_statistics.residentChunks = static_cast<std::uint32_t>(m_resident.size());
+	m_statistics.radius         = m_radius;
+}
+
+void TiledMapStreamer::submit(const Shader* shader, RenderQueue& queue, std::uint8_t renderLayer, std::uint16_t depth) noexcept
+{
+	m_statistics.visibleChunks = 0U;
+
+	forEachChunk(m_view, [&](std::uint32_t id)
+	{
+		const Chunk& chunk = m_chunks[id];
+
+		if (chunk.state != State::Resident || !chunk.quads || !intersects(chunk.bounds, m_view))
+			return;
+
+		DrawPacket packet;
+		packet.shader       = shader;
+		packet.texture      = chunk.texture;
+		packet.vao          = chunk.vao;
+		packet.mode         = GL_TRIANGLES;
+		packet.count        = chunk.quads * 6u;
+		packet.indexType    = GL_UNSIGNED_SHORT;
+		packet.baseInstance = TiledMap::packTileSize(m_tileSize);
+
+		queue.submit(packet, renderLayer, static_cast<std::uint16_t>(depth + chunk.layer));
+
+		++m_statistics.visibleChunks;
+	});
+}
+
+const glm::uvec2& TiledMapStreamer::getTileSize() const noexcept
+{
+	return m_tileSize;
+}
+
+std::size_t TiledMapStreamer::getLayerCount() const noexcept
+{
+	return m_layers.size();
+}
+
+const TiledMapStreamer::Statistics& TiledMapStreamer::getStatistics() const noexcept
+{
+	return m_statistics;
+}
+
+bool TiledMapStreamer::indexChunks(const char* begin, const char* end) noexcept
+{
+	const std::string_view text(begin, static_cast<std::size_t>(end - begin));
+	const std::size_t      offset = static_cast<std::size_t>(begin - m_file.data());
+
+	glm::ivec2 largest(1, 1);
+
+	for (std::size_t layerTag = text.find("<layer"); layerTag != std::string_view::npos; layerTag = text.find("<layer", layerTag + 1U))
+	{
+		const std::size_t layerEnd = text.find("</layer>", layerTag);
+		const std::size_t dataTag  = text.find("<data", layerTag);
+
+		if (layerEnd == std::string_view::npos || dataTag == std::string_view::npos || dataTag > layerEnd)
+			continue;
+
+		const std::string_view layer = text.substr(layerTag, text.find('>', layerTag) - layerTag);
+		const std::string_view data  = text.substr(dataTag, text.find('>', dataTag) - dataTag);
+
+		if (getAttribute(data, "encoding") != "csv")
+		{
+			std::cerr << "Error: layer " << std::string(getAttribute(layer, "name")) << " is not stored as CSV\n";
+
+			continue;
+		}
+
+		const auto layerIndex = static_cast<std::uint32_t>(m_layers.size());
+		m_layers.emplace_back(std::string(getAttribute(layer, "name")));
+
+		for (std::size_t chunkTag = text.find("<chunk", dataTag); chunkTag < layerEnd; chunkTag = text.find("<chunk", chunkTag + 1U))
+		{
+			const std::size_t      tagEnd  = text.find('>', chunkTag);
+			const std::size_t      dataEnd = text.find("</chunk>", tagEnd);
+			const std::string_view tag     = text.substr(chunkTag, tagEnd - chunkTag);
+
+			if (dataEnd == std::string_view::npos)
+				break;
+
+			Chunk chunk;
+			chunk.layer      = layerIndex;
+			chunk.origin     = glm::ivec2(getIntAttribute(tag, "x"), getIntAttribute(tag, "y"));
+			chunk.size       = glm::ivec2(getIntAttribute(tag, "width"), getIntAttribute(tag, "height"));
+			chunk.dataOffset = offset + tagEnd + 1U;
+			chunk.dataSize   = dataEnd - tagEnd - 1U;
+
+//			The origin is stored as two signed 16-bit integers, the quads of a chunk share the 16-bit quad indices
+			if (chunk.size.x <= 0 || chunk.size.y <= 0 || static_cast<std::size_t>(chunk.size.x) * chunk.size.y > PolygonIndexBuffer::MaxQuads ||
+				chunk.origin.x < INT16_MIN || chunk.origin.y < INT16_MIN || chunk.origin.x + chunk.size.x > INT16_MAX || chunk.origin.y + chunk.size.y > INT16_MAX)
+			{
+				std::cerr << "Error: chunk at " << chunk.origin.x << ',' << chunk.origin.y << " is out of the streamable range\n";
+
+				continue;
+			}
+
+			chunk.bounds = glm::vec4(static_cast<float>(chunk.origin.x * static_cast<int>(m_tileSize.x)), static_cast<float>(chunk.origin.y * static_cast<int>(m_tileSize.y)),
+			                         static_cast<float>((chunk.origin.x + chunk.size.x) * static_cast<int>(m_tileSize.x)), static_cast<float>((chunk.origin.y + chunk.size.y) * static_cast<int>(m_tileSize.y)));
+
+			largest = glm::ivec2(std::max(largest.x, chunk.size.x), std::max(largest.y, chunk.size.y));
+			m_chunks.push_back(chunk);
+		}
+	}
+
+//	A chunk is found from the cell of its origin: with cells as large as the largest chunk, an area only
+//	has to be widened by one cell up and left to catch every chunk reaching into it
+	m_cellSize = largest;
+
+	for (std::uint32_t i = 0; i < m_chunks.size(); ++i)
+	{
+		const auto& origin = m_chunks[i].origin;
+
+		m_cells[getCellKey(static_cast<int>(std::floor(static_cast<float>(origin.x) / m_cellSize.x)),
+		                   static_cast<int>(std::floor(static_cast<float>(origin.y) / m_cellSize.y)))].push_back(i);
+	}
+
+	return !m_chunks.empty();
+}
+
+bool TiledMapStreamer::loadTilesets(const char* begin, const char* end) noexcept
+{
+//	Everything before the first layer is small: the map element and the tilesets, closed to parse on its own
+	std::vector<char> header(begin, end);
+	const char        closing[] = "</map>";
+	header.insert(header.end(), closing, closing + sizeof(closing));
+
+	rapidxml::xml_document<char> document;
+	document.parse<0>(header.data());
+
+	const rapidxml::xml_node<char>* mapNode = document.first_node("map");
+
+	if (!mapNode)
+		return false;
+
+	auto infinite = mapNode->first_attribute("infinite");
+	auto tileW    = mapNode->first_attribute("tilewidth");
+	auto tileH    = mapNode->first_attribute("tileheight");
+
+	if (!infinite || std::atoi(infinite->value()) != 1 || !tileW || !tileH)
+		return false;
+
+	const int width  = std::atoi(tileW->value());
+	const int height = std::atoi(tileH->value());
+
+//	Packed into the base instance of the draws
+	if (width <= 0 || height <= 0 || width > UINT16_MAX || height > UINT16_MAX)
+	{
+		std::cerr << "Error: tile size " << width << 'x' << height << " is out of range\n";
+
+		return false;
+	}
+
+	m_tileSize = glm::uvec2(width, height);
+
+	std::vector<const rapidxml::xml_node<char>*> tilesetNodes;
+	std::vector<Texture2D*> textures;
+
+//	Requested together, so they are decoded in parallel
+	for (auto tilesetNode = mapNode->first_node("tileset");
+		      tilesetNode != nullptr;
+		      tilesetNode = tilesetNode->next_sibling("tileset"))
+	{
+		auto imageNode  = tilesetNode->first_node("image");
+		auto sourceNode = imageNode ? imageNode->first_attribute("source") : nullptr;
+
+		std::string texName = sourceNode ? sourceNode->value() : std::string();
+
+		if (texName.empty())
+			continue;
+
+		if (const std::size_t slash = texName.find_last_of('/'); slash != std::string::npos)
+			texName.erase(0, slash + 1);
+
+		if (auto texture = AssetManager::acquireAsync<Texture2D>(texName); texture)
+		{
+			tilesetNodes.push_back(tilesetNode);
+			textures.push_back(texture.get());
+			m_textures.push_back(std::move(texture));
+		}
+	}
+
+	AssetManager::wait(textures);
+
+	for (std::size_t i = 0; i < tilesetNodes.size(); ++i)
+	{
+		if (!textures[i]->isResident())
+			continue;
+
+		auto tileCount = tilesetNodes[i]->first_attribute("tilecount");
+		auto columns   = tilesetNodes[i]->first_attribute("columns");
+		auto firstGID  = tilesetNodes[i]->first_attribute("firstgid");
+
+		Tileset& tileset  = m_tilesets.emplace_back();
+		tileset.texture   = textures[i]->getNativeHandle();
+		tileset.tileCount = tileCount ? std::atoi(tileCount->value()) : 0;
+		tileset.columns   = columns ? std::max(std::atoi(columns->value()), 1) : 1;
+		tileset.firstGID  = firstGID ? std::atoi(firstGID->value()) : 1;
+		tileset.texelSize = 1.0f / glm::vec2(textures[i]->getSize());
+	}
+
+	std::sort(m_tilesets.begin(), m_tilesets.end(), [](const Tileset& left, const Tileset& right) { return left.firstGID < right.firstGID; });
+
+	return !m_tilesets.empty() && m_tileSize.x && m_tileSize.y;
+}
+
+void TiledMapStreamer::mesh(std::uint32_t chunk, std::uint32_t request) noexcept
+{
+//	Only the index of the chunk is read here, never its streaming state
+	const Chunk& source = m_chunks[chunk];
+	const char*  data   = m_file.data() + source.dataOffset;
+	const char*  end    = data + source.dataSize;
+
+	Mesh mesh;
+	mesh.chunk   = chunk;
+	mesh.request = request;
+	mesh.vertices.reserve(static_cast<std::size_t>(source.size.x) * source.size.y * 4U);
+
+	const Tileset* tileset = nullptr;
+	const int      tileW   = static_cast<int>(m_tileSize.x);
+	const int      tileH   = static_cast<int>(m_tileSize.y);
+	const int      tiles   = source.size.x * source.size.y;
+
+	int index = 0;
+
+	while (data < end && index < tiles)
+	{
+		if (*data < '0' || *data > '9')
+		{
+			++data;
+
+			continue;
+		}
+
+		std::uint32_t gid = 0U;
+
+		for (; data < end && *data >= '0' && *data <= '9'; ++data)
+			gid = gid * 10U + static_cast<std::uint32_t>(*data - '0');
+
+		const int x    = index % source.size.x;
+		const int y    = index / source.size.x;
+		const int tile = static_cast<int>(gid & ~FlipFlags);
+
+		++index;
+
+		if (!tile)
+			continue;
+
+//		The chunk keeps the tileset of its first tile, see the class comment
+		if (!tileset)
+		{
+			for (const auto& candidate : m_tilesets)
+				if (candidate.firstGID <= tile)
+					tileset = &candidate;
+
+			if (!tileset)
+				continue;
+
+			mesh.texture = tileset->texture;
+		}
+
+		const int tileNum = tile - tileset->firstGID;
+
+		if (tileNum < 0 || tileNum >= tileset->tileCount)
+			continue;
+
+		const int offsetX = (tileNum % tileset->columns) * tileW;
+		const int offsetY = (tileNum / tileset->columns) * tileH;
+
+		const float left   = offsetX * tileset->texelSize.x;
+		const float top    = offsetY * tileset->texelSize.y;
+		const float right  = (offsetX + tileW) * tileset->texelSize.x;
+		const float bottom = (offsetY + tileH) * tileset->texelSize.y;
+
+		const auto tileLeft   = static_cast<std::uint16_t>(x);
+		const auto tileTop    = static_cast<std::uint16_t>(y);
+		const auto tileRight  = static_cast<std::uint16_t>(x + 1);
+		const auto tileBottom = static_cast<std::uint16_t>(y + 1);
+
+		mesh.vertices.emplace_back(tileLeft,  tileBottom, left,  bottom);
+		mesh.vertices.emplace_back(tileRight, tileBottom, right, bottom);
+		mesh.vertices.emplace_back(tileRight, tileTop,    right, top);
+		mesh.vertices.emplace_back(tileLeft,  tileTop,    left,  top);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_meshes.push_back(std::move(mesh));
+		--m_inFlight;
+	}
+
+	m_idle.notify_all();
+}
+
+void TiledMapStreamer::upload(Mesh& mesh) noexcept
+{
+	Chunk& chunk  = m_chunks[mesh.chunk];
+	chunk.state   = State::Resident;
+	chunk.texture = mesh.texture;
+	chunk.quads   = static_cast<unsigned>(mesh.vertices.size() / 4U);
+
+	++m_statistics.loadedChunks;
+
+	if (!chunk.quads)
+		return;
+
+//	The chunk origin in tiles follows the vertices, read by every vertex through a zero stride binding
+	const std::int16_t origin[2]   = { static_cast<std::int16_t>(chunk.origin.x), static_cast<std::int16_t>(chunk.origin.y) };
+	const std::size_t  vertexBytes = sizeof(PackedVertex2D) * mesh.vertices.size();
+	chunk.bytes                    = vertexBytes + sizeof(origin);
+
+	glGenVertexArrays(1, &chunk.vao);
+	glGenBuffers(1, &chunk.vbo);
+
+	glBindVertexArray(chunk.vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+	glBufferData(GL_ARRAY_BUFFER, chunk.bytes, nullptr, GL_STATIC_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, mesh.vertices.data());
+	glBufferSubData(GL_ARRAY_BUFFER, vertexBytes, sizeof(origin), origin);
+
+	glVertexAttribPointer(0, 2, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(PackedVertex2D), nullptr);
+	glEnableVertexAttribArray(0);
+
+	glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex2D), (void*)offsetof(PackedVertex2D, texCoords));
+	glEnableVertexAttribArray(1);
+
+	glVertexAttribIFormat(2, 2, GL_SHORT, 0);
+	glVertexAttribBinding(2, 2);
+	glBindVertexBuffer(2, chunk.vbo, static_cast<GLintptr>(vertexBytes), 0);
+	glEnableVertexAttribArray(2);
+
+	m_quadIndices.bind();
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_statistics.residentBytes += chunk.bytes;
+}
+
+void TiledMapStreamer::evict(std::uint32_t id) noexcept
+{
+	Chunk& chunk = m_chunks[id];
+
+	if (chunk.vao)
+		glDeleteVertexArrays(1, &chunk.vao);
+
+	if (chunk.vbo)
+		glDeleteBuffers(1, &chunk.vbo);
+
+	m_statistics.residentBytes -= chunk.bytes;
+	++m_statistics.evictedChunks;
+
+	chunk.state   = State::Unloaded;
+	chunk.texture = 0U;
+	chunk.vao     = 0U;
+	chunk.vbo     = 0U;
+	chunk.quads   = 0U;
+	chunk.bytes   = 0U;
+}
+
+template <class Function>
+void TiledMapStreamer::forEachChunk(const glm::vec4& area, Function&& function) const noexcept
+{
+	if (m_chunks.empty())
+		return;
+
+	const float cellW = static_cast<float>(m_cellSize.x * static_cast<int>(m_tileSize.x));
+	const float cellH = static_cast<float>(m_cellSize.y * static_cast<int>(m_tileSize.y));
+
+	const int firstX = static_cast<int>(std::floor(area.x / cellW)) - 1;
+	const int firstY = static_cast<int>(std::floor(area.y / cellH)) - 1;
+	const int lastX  = static_cast<int>(std::floor(area.z / cellW));
+	const int lastY  = static_cast<int>(std::floor(area.w / cellH));
+
+	for (int y = firstY; y <= lastY; ++y)
+		for (int x = firstX; x <= lastX; ++x)
+			if (auto found = m_cells.find(getCellKey(x, y)); found != m_cells.end())
+				for (const auto chunk : found->second)
+					function(chunk);
+}
+
+std::uint64_t TiledMapStreamer::getCellKey(int x, int y) const noexcept
+{
+	return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+}
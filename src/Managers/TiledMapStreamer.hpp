@@ -0,0 +1,158 @@
+#ifndef TILED_MAP_STREAMER_HPP
+#define TILED_MAP_STREAMER_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "system/NonCopyable.hpp"
+#include "system/StringId.hpp"
+#include "system/FileView.hpp"
+#include "graphics/PackedVertex2D.hpp"
+#include "graphics/PolygonIndexBuffer.hpp"
+#include "managers/AssetHandle.hpp"
+
+// Streams a Tiled map saved in the infinite format (layers made of <chunk> elements in CSV) around the view.
+// Opening only indexes where the chunks are in the mapped file; the chunks within Settings::radius of the
+// view are parsed and meshed on the pool, uploaded a few per update, and evicted once out of reach or when
+// the meshes exceed the memory budget, farthest first. A budget eviction also shrinks the reach below the
+// evicted chunks, so they are not requested again; it grows back once the view has moved and memory is free.
+// Memory and loading time follow the view, not the map.
+// Meant for tilemap_chunks.vert: a chunk is meshed in tiles relative to its origin, stored after its vertices,
+// so tile coordinates only have to fit in 16 signed bits. Its draw carries the tile size in the base instance.
+// Like the fixed-size loader, a chunk is drawn from a single tileset, the one of its first tile
+class TiledMapStreamer:
+	private NonCopyable
+{
+public:
+	struct Settings
+	{
+		float       radius       = 512.0f;             // Pixels around the view within which chunks are kept
+		std::size_t memoryBudget = 16U * 1024U * 1024U; // Bytes of resident meshes
+		unsigned    maxLoads     = 16U;                 // Chunks being prepared on the pool at once
+		unsigned    maxUploads   = 8U;                  // Meshes sent to the GPU per update
+	};
+
+	struct Statistics
+	{
+		std::uint32_t indexedChunks  = 0U; // In the file
+		std::uint32_t residentChunks = 0U;
+		std::uint32_t pendingChunks  = 0U; // Queued or being meshed
+		std::uint32_t visibleChunks  = 0U; // Of the last submit
+		std::uint64_t residentBytes  = 0U;
+		std::uint64_t loadedChunks   = 0U; // Since open
+		std::uint64_t evictedChunks  = 0U;
+		float         radius         = 0.0f; // Current reach around the view, at most Settings::radius
+	};
+
+public:
+	explicit TiledMapStreamer(class ThreadPool& pool) noexcept;
+	~TiledMapStreamer();
+
+	bool open(const StringId& filename) noexcept;
+	bool open(const StringId& filename, const Settings& settings) noexcept;
+	void close() noexcept; // Waits for the chunks being meshed
+
+//	GL thread, once per frame: uploads what the pool has meshed, requests the chunks around the view, evicts the others
+	void update(const glm::mat4& viewProjection) noexcept;
+
+//	The resident chunks on screen as of the last update, layer i at depth + i
+	void submit(const class Shader* shader, class RenderQueue& queue, std::uint8_t renderLayer, std::uint16_t depth = 0U) noexcept;
+
+	const glm::uvec2& getTileSize()   const noexcept;
+	std::size_t       getLayerCount() const noexcept;
+	const Statistics& getStatistics() const noexcept;
+
+private:
+	enum class State : std::uint8_t
+	{
+		Unloaded,
+		Loading,
+		Resident
+	};
+
+	struct Tileset
+	{
+		unsigned  texture   = 0U;
+		int       firstGID  = 1;
+		int       tileCount = 0;
+		int       columns   = 0;
+		glm::vec2 texelSize { 0.0f }; // 1 / texture size
+	};
+
+	struct Chunk
+	{
+//		From the index
+		std::uint32_t layer      = 0U;
+		glm::ivec2    origin     { 0 }; // In tiles
+		glm::ivec2    size       { 0 };
+		std::size_t   dataOffset = 0U;  // CSV text in the file
+		std::size_t   dataSize   = 0U;
+		glm::vec4     bounds     { 0.0f }; // In pixels: left, top, right, bottom
+
+//		Streaming state, only touched on the GL thread
+		State         state    = State::Unloaded;
+		std::uint32_t request  = 0U; // Bumped by every request, so a stale mesh is recognized
+		std::uint64_t lastSeen = 0U; // Last update that wanted the chunk
+		unsigned      texture  = 0U;
+		unsigned      vao      = 0U;
+		unsigned      vbo      = 0U;
+		unsigned      quads    = 0U;
+		std::size_t   bytes    = 0U; // Of the vertex buffer
+	};
+
+//	Built on the pool
+	struct Mesh
+	{
+		std::uint32_t               chunk   = 0U;
+		std::uint32_t               request = 0U;
+		unsigned                    texture = 0U;
+		std::vector<PackedVertex2D> vertices;
+	};
+
+	bool indexChunks(const char* begin, const char* end) noexcept;
+	bool loadTilesets(const char* begin, const char* end) noexcept;
+	void mesh(std::uint32_t chunk, std::uint32_t request) noexcept;
+	void upload(Mesh& mesh) noexcept;
+	void evict(std::uint32_t chunk) noexcept;
+
+	template <class Function>
+	void forEachChunk(const glm::vec4& area, Function&& function) const noexcept; // Chunks whose cell may meet the area
+
+	std::uint64_t getCellKey(int x, int y) const noexcept;
+
+private:
+	class ThreadPool& m_pool;
+	Settings          m_settings;
+	FileView          m_file;
+
+	std::vector<AssetHandle<class Texture2D>> m_textures;
+	std::vector<Tileset>                      m_tilesets;
+	std::vector<StringId>                     m_layers;
+	std::vector<Chunk>                        m_chunks;
+	std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_cells; // Chunks by cell of the largest chunk size
+	glm::ivec2                                m_cellSize;
+	glm::uvec2                                m_tileSize;
+
+	std::vector<std::uint32_t> m_resident;
+	std::vector<std::uint32_t> m_candidates; // Scratch of update
+	PolygonIndexBuffer         m_quadIndices;
+	glm::vec4                  m_view; // Visible area in pixels: left, top, right, bottom
+	std::uint64_t              m_frame;
+	float                      m_radius;     // Reach, shrunk to what the budget holds
+	glm::vec4                  m_shrunkView; // View of the last shrink: the reach only grows again once it moved
+
+//	Shared with the pool
+	std::mutex              m_mutex;
+	std::condition_variable m_idle;
+	std::vector<Mesh>       m_meshes;   // Finished, waiting for upload
+	unsigned                m_inFlight;
+
+	Statistics m_statistics;
+};
+
+#endif // !TILED_MAP_STREAMER_HPP
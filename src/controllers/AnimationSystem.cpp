@@ -0,0 +1,351 @@
+#include <algorithm>
+
+#include "controllers/AnimationSystem.hpp"
+
+namespace
+{
+    constexpr std::uint8_t Deferred = 1U << 7; // In the events of an instance left to AnimationSystem::advance
+
+//  The common case, at most one frame per update, is compare-and-subtract and every branch is a select,
+//  so the loop vectorizes. Instances that cover several frames at once only take the time and are marked
+//  Deferred, AnimationSystem::advance steps them with divisions. The arrays are distinct vectors of the
+//  playback: restrict spares the vectorizer the overlap checks it would give up on
+    void stepPlayback(std::size_t count, int dt, std::int32_t* __restrict frames, std::int32_t* __restrict timers,
+                      std::uint8_t* __restrict flags, std::uint8_t* __restrict events,
+                      const std::int32_t* __restrict durations, const std::int32_t* __restrict delays) noexcept
+    {
+        using Flags = AnimationSystem::Flags;
+        using Event = AnimationSystem::Event;
+
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const std::uint8_t state    = flags[i];
+            const bool         isActive = (state & (Flags::Playing | Flags::Over)) == Flags::Playing;
+            const bool         reversed = (state & Flags::Reversed) != 0;
+            const bool         looped   = (state & Flags::Looped) != 0;
+
+//          Instances without a clip have neither, they are never active
+            const std::int32_t duration = std::max(durations[i], 1);
+            const std::int32_t delay    = std::max(delays[i], 1);
+
+            const std::int32_t timer    = timers[i] + (isActive ? dt : 0);
+            const bool         isSlow   = isActive && timer >= 2 * delay;
+            const std::int32_t steps    = (isActive && !isSlow && timer >= delay) ? 1 : 0;
+
+//          Frames played so far, counted from the first one in the playing direction: one step goes at most one past the last
+            const std::int32_t played   = (reversed ? duration - 1 - frames[i] : frames[i]) + steps;
+            const bool         isOut    = played >= duration;
+            const std::int32_t position = played - (isOut ? (looped ? duration : 1) : 0);
+
+            frames[i] = reversed ? duration - 1 - position : position;
+            timers[i] = timer - steps * delay;
+            flags[i]  = static_cast<std::uint8_t>(state | (isOut && !looped ? Flags::Over : 0));
+
+//          Products rather than selects of constants, which gcc does not if-convert
+            events[i] = static_cast<std::uint8_t>(isSlow * Deferred + (isOut && !looped) * (1U << Event::Finished) + (isOut && looped) * (1U << Event::Wrapped));
+        }
+    }
+}
+
+AnimationSystem* AnimationSystem::m_instance;
+
+AnimationSystem::AnimationSystem() noexcept
+{
+    if(!m_instance)
+        m_instance = this;
+}
+
+AnimationSystem::~AnimationSystem()
+{
+    if(m_instance == this)
+        m_instance = nullptr;
+}
+
+AnimationSystem* AnimationSystem::getInstance() noexcept
+{
+    return m_instance;
+}
+
+AnimationSystem::ClipId AnimationSystem::addClip(const StringId& name, const Animation& animation) noexcept
+{
+    if(auto found = m_clipNames.find(name); found != m_clipNames.end())
+        return (m_clips[found->second] == animation && m_clips[found->second].delay == animation.delay) ? found->second : Invalid;
+
+    const auto clip = static_cast<ClipId>(m_clips.size());
+
+    m_clips.push_back(animation);
+    m_clipNames.emplace(name, clip);
+
+    return clip;
+}
+
+AnimationSystem::ClipId AnimationSystem::findClip(const StringId& name) const noexcept
+{
+    auto found = m_clipNames.find(name);
+
+    return (found != m_clipNames.end()) ? found->second : Invalid;
+}
+
+const Animation* AnimationSystem::getClip(ClipId clip) const noexcept
+{
+    return (clip < m_clips.size()) ? &m_clips[clip] : nullptr;
+}
+
+const std::vector<Animation>& AnimationSystem::getClips() const noexcept
+{
+    return m_clips;
+}
+
+AnimationSystem::Instance AnimationSystem::create(ClipId clip) noexcept
+{
+    Instance instance;
+
+    if(!m_freeInstances.empty())
+    {
+        instance = m_freeInstances.back();
+        m_freeInstances.pop_back();
+    }
+    else
+    {
+        instance = static_cast<Instance>(m_slots.size());
+        m_slots.push_back(Invalid);
+    }
+
+    m_slots[instance] = static_cast<std::uint32_t>(m_playback.getSize());
+    m_playback.push(instance);
+
+    if(clip != Invalid)
+        setClip(instance, clip);
+
+    return instance;
+}
+
+void AnimationSystem::destroy(Instance instance) noexcept
+{
+    const std::uint32_t slot = getSlot(instance);
+
+    if(slot == Invalid)
+        return;
+
+//  The last entry fills the hole, so the arrays stay packed
+    const std::size_t last = m_playback.getSize() - 1U;
+
+    if(slot != last)
+    {
+        m_playback.moveTo(last, slot);
+        m_slots[m_playback.owners[slot]] = slot;
+    }
+
+    m_playback.pop();
+    m_slots[instance] = Invalid;
+    m_freeInstances.push_back(instance);
+}
+
+void AnimationSystem::setClip(Instance instance, ClipId clip) noexcept
+{
+    const std::uint32_t slot = getSlot(instance);
+
+    if(slot == Invalid || clip >= m_clips.size())
+        return;
+
+    const Animation& animation = m_clips[clip];
+
+    m_playback.clips[slot]     = clip;
+    m_playback.firsts[slot]    = animation.first;
+    m_playback.durations[slot] = static_cast<std::int32_t>(animation.duration);
+    m_playback.delays[slot]    = static_cast<std::int32_t>(std::max(animation.delay, 1U));
+    m_playback.frames[slot]    = 0;
+    m_playback.timers[slot]    = 0;
+    m_playback.flags[slot]     = Playing;
+    m_playback.events[slot]    = 0U;
+}
+
+void AnimationSystem::setFlag(Instance instance, Flags flag, bool on) noexcept
+{
+    const std::uint32_t slot = getSlot(instance);
+
+    if(slot == Invalid)
+        return;
+
+    auto& flags = m_playback.flags[slot];
+
+//  A finished clip does not play again until it is restarted
+    if(flag == Playing && on && (flags & Over))
+        return;
+
+    flags = on ? (flags | flag) : (flags & ~flag);
+}
+
+void AnimationSystem::restart(Instance instance) noexcept
+{
+    const std::uint32_t slot = getSlot(instance);
+
+    if(slot == Invalid)
+        return;
+
+    m_playback.frames[slot] = (m_playback.flags[slot] & Reversed) ? m_playback.durations[slot] - 1 : 0;
+    m_playback.timers[slot] = 0;
+    m_playback.flags[slot] &= ~Over;
+}
+
+void AnimationSystem::update(int dt) noexcept
+{
+    const std::size_t count  = m_playback.getSize();
+    std::uint8_t*     events = m_playback.events.data();
+
+    stepPlayback(count, dt, m_playback.frames.data(), m_playback.timers.data(), m_playback.flags.data(), events,
+                 m_playback.durations.data(), m_playback.delays.data());
+
+    m_events.clear();
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        if(events[i] == 0U)
+            continue;
+
+        if(events[i] == Deferred)
+            events[i] = advance(i);
+
+        if(events[i] == 0U)
+            continue;
+
+        const Event::Type type = (events[i] & (1U << Event::Finished)) ? Event::Finished : Event::Wrapped;
+
+        m_events.push_back({ type, m_playback.owners[i], m_playback.clips[i] });
+    }
+}
+
+std::uint8_t AnimationSystem::advance(std::size_t slot) noexcept
+{
+    const std::uint8_t state    = m_playback.flags[slot];
+    const bool         reversed = (state & Reversed) != 0;
+    const bool         looped   = (state & Looped) != 0;
+    const std::int32_t duration = std::max(m_playback.durations[slot], 1);
+    const std::int32_t delay    = std::max(m_playback.delays[slot], 1);
+
+//  The timer already holds the time of this update. The frames move by timer / delay steps and the timer keeps
+//  the remainder: after any sequence of updates the frame is Animation::getFrameAt of the time played
+    const std::int32_t timer    = m_playback.timers[slot];
+    const std::int32_t steps    = timer / delay;
+    const std::int32_t played   = (reversed ? duration - 1 - m_playback.frames[slot] : m_playback.frames[slot]) + steps;
+    const bool         isOut    = played >= duration;
+    const std::int32_t position = looped ? played % duration : std::min(played, duration - 1);
+
+    m_playback.frames[slot] = reversed ? duration - 1 - position : position;
+    m_playback.timers[slot] = timer - steps * delay;
+
+    if(isOut && !looped)
+    {
+        m_playback.flags[slot] = static_cast<std::uint8_t>(state | Over);
+
+        return 1U << Event::Finished;
+    }
+
+    return isOut ? 1U << Event::Wrapped : 0U;
+}
+
+std::uint32_t AnimationSystem::getCurrentFrame(Instance instance) const noexcept
+{
+    const std::uint32_t slot = getSlot(instance);
+
+    if(slot == Invalid || m_playback.clips[slot] == Invalid || m_playback.durations[slot] <= 0)
+        return Animation::InvalidFrame;
+
+    return m_playback.firsts[slot] + static_cast<std::uint32_t>(m_playback.frames[slot]);
+}
+
+int AnimationSystem::getTimeToNextFrame(Instance instance) const noexcept
+{
+    const std::uint32_t slot = getSlot(instance);
+
+    if(slot == Invalid || (m_playback.flags[slot] & (Playing | Over)) != Playing)
+        return -1;
+
+    return std::max(m_playback.delays[slot] - m_playback.timers[slot], 0);
+}
+
+int AnimationSystem::getTimeToEnd(Instance instance) const noexcept
+{
+    const std::uint32_t slot = getSlot(instance);
+
+    if(slot == Invalid || (m_playback.flags[slot] & (Playing | Over)) != Playing)
+        return -1;
+
+//  The clip ends on the step that leaves its last frame
+    const std::int32_t steps = (m_playback.flags[slot] & Reversed) ? m_playback.frames[slot] + 1 : m_playback.durations[slot] - m_playback.frames[slot];
+
+    return std::max(steps * m_playback.delays[slot] - m_playback.timers[slot], 0);
+}
+
+AnimationSystem::ClipId AnimationSystem::getClipOf(Instance instance) const noexcept
+{
+    const std::uint32_t slot = getSlot(instance);
+
+    return (slot != Invalid) ? m_playback.clips[slot] : Invalid;
+}
+
+std::uint8_t AnimationSystem::getFlags(Instance instance) const noexcept
+{
+    const std::uint32_t slot = getSlot(instance);
+
+    return (slot != Invalid) ? m_playback.flags[slot] : 0U;
+}
+
+const std::vector<AnimationSystem::Event>& AnimationSystem::getEvents() const noexcept
+{
+    return m_events;
+}
+
+std::size_t AnimationSystem::getInstanceCount() const noexcept
+{
+    return m_playback.getSize();
+}
+
+std::uint32_t AnimationSystem::getSlot(Instance instance) const noexcept
+{
+    return (instance < m_slots.size()) ? m_slots[instance] : Invalid;
+}
+
+std::size_t AnimationSystem::Playback::getSize() const noexcept
+{
+    return owners.size();
+}
+
+void AnimationSystem::Playback::push(Instance instance) noexcept
+{
+    clips.push_back(Invalid);
+    firsts.push_back(0U);
+    durations.push_back(0);
+    delays.push_back(0);
+    frames.push_back(0);
+    timers.push_back(0);
+    flags.push_back(0U);
+    events.push_back(0U);
+    owners.push_back(instance);
+}
+
+void AnimationSystem::Playback::moveTo(std::size_t from, std::size_t to) noexcept
+{
+    clips[to]     = clips[from];
+    firsts[to]    = firsts[from];
+    durations[to] = durations[from];
+    delays[to]    = delays[from];
+    frames[to]    = frames[from];
+    timers[to]    = timers[from];
+    flags[to]     = flags[from];
+    events[to]    = events[from];
+    owners[to]    = owners[from];
+}
+
+void AnimationSystem::Playback::pop() noexcept
+{
+    clips.pop_back();
+    firsts.pop_back();
+    durations.pop_back();
+    delays.pop_back();
+    frames.pop_back();
+    timers.pop_back();
+    flags.pop_back();
+    events.pop_back();
+    owners.pop_back();
+}
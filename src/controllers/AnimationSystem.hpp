@@ -0,0 +1,115 @@
+#ifndef ANIMATION_SYSTEM_HPP
+#define ANIMATION_SYSTEM_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "system/NonCopyable.hpp"
+#include "system/StringId.hpp"
+#include "graphics/Animation.hpp"
+
+// Plays every animation of the game in one pass. The clips live once in a shared library, the playback
+// state of the instances is kept as parallel arrays packed without holes, so update() is a linear loop over
+// plain integers, branch-free for the instances that move by at most one frame. Clip ends are reported as one
+// list of events per update.
+// The first system constructed becomes the one Animator attaches to by default
+class AnimationSystem:
+	private NonCopyable
+{
+public:
+	using ClipId   = std::uint32_t;
+	using Instance = std::uint32_t;
+
+	static constexpr std::uint32_t Invalid = UINT32_MAX;
+
+	enum Flags : std::uint8_t
+	{
+		Playing  = 1U << 0,
+		Looped   = 1U << 1,
+		Over     = 1U << 2,
+		Reversed = 1U << 3
+	};
+
+	struct Event
+	{
+		enum Type : std::uint8_t
+		{
+			Finished, // Reached the end of a clip that does not loop
+			Wrapped   // Started a looped clip over
+		};
+
+		Type     type;
+		Instance instance;
+		ClipId   clip;
+	};
+
+public:
+	AnimationSystem() noexcept;
+	~AnimationSystem();
+
+	static AnimationSystem* getInstance() noexcept;
+
+//	A name already in the library gives its clip back if the frames are the same, Invalid otherwise
+	ClipId           addClip(const StringId& name, const Animation& animation) noexcept;
+	ClipId           findClip(const StringId& name) const noexcept;
+	const Animation* getClip(ClipId clip) const noexcept; // Valid until clips are added
+
+	const std::vector<Animation>& getClips() const noexcept; // Indexed by ClipId
+
+	Instance create(ClipId clip = Invalid) noexcept;
+	void     destroy(Instance instance) noexcept;
+
+//	Starts the clip from its first frame, playing, forward and not looped
+	void setClip(Instance instance, ClipId clip) noexcept;
+	void setFlag(Instance instance, Flags flag, bool on) noexcept;
+	void restart(Instance instance) noexcept;
+
+//	Advances every instance by dt milliseconds, as many frames as that covers, and replaces the events of the previous update
+	void update(int dt) noexcept;
+
+	std::uint32_t getCurrentFrame(Instance instance)    const noexcept; // Index into the SpriteManager frame arena, or Animation::InvalidFrame
+	ClipId        getClipOf(Instance instance)          const noexcept;
+	std::uint8_t  getFlags(Instance instance)           const noexcept;
+	int           getTimeToNextFrame(Instance instance) const noexcept; // Milliseconds, -1 if the instance does not play
+	int           getTimeToEnd(Instance instance)       const noexcept; // Until the clip finishes or wraps, -1 if it does not play
+
+	const std::vector<Event>& getEvents()        const noexcept;
+	std::size_t               getInstanceCount() const noexcept;
+
+private:
+//	One entry per live instance. The clip fields are copied in, so the update never looks the clip up
+	struct Playback
+	{
+		std::vector<ClipId>        clips;
+		std::vector<std::uint32_t> firsts;
+		std::vector<std::int32_t>  durations;
+		std::vector<std::int32_t>  delays;
+		std::vector<std::int32_t>  frames; // Relative to the first frame of the clip
+		std::vector<std::int32_t>  timers;
+		std::vector<std::uint8_t>  flags;
+		std::vector<std::uint8_t>  events; // 1 << Event::Type, written by the last update
+		std::vector<Instance>      owners; // Instance of each entry
+
+		std::size_t getSize() const noexcept;
+		void        push(Instance instance) noexcept;
+		void        moveTo(std::size_t from, std::size_t to) noexcept;
+		void        pop() noexcept;
+	};
+
+	std::uint32_t getSlot(Instance instance) const noexcept; // Invalid if the instance does not exist
+	std::uint8_t  advance(std::size_t slot) noexcept; // Update of an instance covering several frames, returns its events
+
+private:
+	static AnimationSystem* m_instance;
+
+	std::vector<Animation>               m_clips;
+	std::unordered_map<StringId, ClipId> m_clipNames;
+
+	Playback                   m_playback;
+	std::vector<std::uint32_t> m_slots;         // Entry of each instance in m_playback, Invalid once destroyed
+	std::vector<Instance>      m_freeInstances;
+	std::vector<Event>         m_events;
+};
+
+#endif // !ANIMATION_SYSTEM_HPP
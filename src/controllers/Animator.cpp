@@ -1,34 +1,40 @@
-#include "graphics/Texture2D.hpp"
-#include "graphics/Sprite2D.hpp"
+#include <algorithm>
+
 #include "controllers/Animator.hpp"
 
 Animator::Animator() noexcept:
-    m_currentFrame(0),
-    m_timer(0)
+    m_system(AnimationSystem::getInstance()),
+    m_instance(m_system ? m_system->create() : AnimationSystem::Invalid)
+{
+}
+
+Animator::Animator(AnimationSystem& system) noexcept:
+    m_system(&system),
+    m_instance(system.create())
 {
 }
 
 Animator::~Animator()
 {
-    m_animations.clear();
+    if(m_system)
+        m_system->destroy(m_instance);
 }
 
-bool Animator::addAnimation(const std::string& name, const Animation& anim) noexcept
+bool Animator::addAnimation(const StringId& name, const Animation& anim) noexcept
 {
-    return m_animations.try_emplace(name, anim).second;
+    return m_system && m_system->addClip(name, anim) != AnimationSystem::Invalid;
 }
 
-bool Animator::setAnimation(const std::string& name) noexcept
+bool Animator::setAnimation(const StringId& name) noexcept
 {
-    if(auto found = m_animations.find(name); found != m_animations.end())
+    if(!m_system)
+        return false;
+
+    if(auto clip = m_system->findClip(name); clip != AnimationSystem::Invalid)
     {
-        if(m_currentAnimation != found->second)
+        if(m_system->getClipOf(m_instance) != clip)
         {
-            restart();
-            loop(false);
-            reverse(false);
-            play();
-            m_currentAnimation = found->second;
+            m_system->setClip(m_instance, clip);
 
             return true;
         }
@@ -37,76 +43,84 @@ bool Animator::setAnimation(const std::string& name) noexcept
     return false;
 }
 
-void Animator::update(int dt) noexcept
-{
-    bool needToPlay = (m_status.isPlaying && ( ! m_status.isOver ));
-
-    if (needToPlay) 
-    {
-        m_timer += dt;
-
-        if(m_timer > m_currentAnimation.delay)
-        {
-            m_currentFrame += m_status.isReversed ? -1 : 1;
-            m_timer = 0;
-
-            bool isOutOfRange = m_status.isReversed ? (m_currentFrame < 0) : (m_currentFrame >= m_currentAnimation.duration);
-
-            if (isOutOfRange)
-            { 
-                if ( ! m_status.isLooped )
-                {
-                    m_status.isOver = true;
-                    return;
-                }
-                restart();
-            }
-        }
-    }
-}
-
 void Animator::stop() noexcept
 {
-    m_status.isPlaying = false;
+    if(m_system)
+        m_system->setFlag(m_instance, AnimationSystem::Playing, false);
 }
 
 void Animator::play() noexcept
 {
-    if( ! m_status.isOver )
-        m_status.isPlaying = true;
+    if(m_system)
+        m_system->setFlag(m_instance, AnimationSystem::Playing, true);
 }
 
 void Animator::loop(bool b) noexcept
 {
-    m_status.isLooped = b;
+    if(m_system)
+        m_system->setFlag(m_instance, AnimationSystem::Looped, b);
 }
 
 void Animator::restart() noexcept
 {
-    m_currentFrame  = m_status.isReversed ? (m_currentAnimation.duration - 1) : 0;
-    m_timer         = 0;
-    m_status.isOver = false;
+    if(m_system)
+        m_system->restart(m_instance);
 }
 
 void Animator::reverse(bool r) noexcept
 {
-    m_status.isReversed = r;
+    if(m_system)
+        m_system->setFlag(m_instance, AnimationSystem::Reversed, r);
 }
 
-const Sprite2D* Animator::getCurrentFrame() const noexcept
+std::uint32_t Animator::getCurrentFrame() const noexcept
 {
-    if(m_currentAnimation.sprites != nullptr)
-        return m_currentAnimation.sprites + m_currentFrame;
-
-    return nullptr;
+    return m_system ? m_system->getCurrentFrame(m_instance) : Animation::InvalidFrame;
 }
 
 const Animation* Animator::getAnimation() const noexcept
 {
-    return &m_currentAnimation;
+    return m_system ? m_system->getClip(m_system->getClipOf(m_instance)) : nullptr;
+}
+
+Animator::Status Animator::getStatus() const noexcept
+{
+    const std::uint8_t flags = m_system ? m_system->getFlags(m_instance) : 0U;
+
+    Status status;
+    status.isPlaying  = (flags & AnimationSystem::Playing) != 0;
+    status.isLooped   = (flags & AnimationSystem::Looped) != 0;
+    status.isOver     = (flags & AnimationSystem::Over) != 0;
+    status.isReversed = (flags & AnimationSystem::Reversed) != 0;
+
+    return status;
+}
+
+AnimationSystem::Instance Animator::getInstance() const noexcept
+{
+    return m_instance;
+}
+
+TimerWheel::TimerId Animator::scheduleFrameChange(TimerWheel& wheel, TimerWheel::Callback callback) const noexcept
+{
+    const Animation* animation = getAnimation();
+    const int        delay     = m_system ? m_system->getTimeToNextFrame(m_instance) : -1;
+
+    if(!animation || delay < 0)
+        return TimerWheel::InvalidTimer;
+
+    return wheel.schedule(static_cast<std::uint64_t>(delay), std::move(callback), std::max(animation->delay, 1U));
 }
 
-const Animator::Status* Animator::getStatus() const noexcept
+TimerWheel::TimerId Animator::scheduleClipEnd(TimerWheel& wheel, TimerWheel::Callback callback) const noexcept
 {
-    return &m_status;
-}
\ No newline at end of file
+    const Animation* animation = getAnimation();
+    const int        delay     = m_system ? m_system->getTimeToEnd(m_instance) : -1;
+
+    if(!animation || delay < 0)
+        return TimerWheel::InvalidTimer;
+
+    const std::uint64_t period = getStatus().isLooped ? std::uint64_t(animation->duration) * std::max(animation->delay, 1U) : 0U;
+
+    return wheel.schedule(static_cast<std::uint64_t>(delay), std::move(callback), period);
+}
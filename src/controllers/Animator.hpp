@@ -1,12 +1,18 @@
 #ifndef ANIMATOR_HPP
 #define ANIMATOR_HPP
 
-#include <string>
-#include <unordered_map>
+#include <cstdint>
 
+#include "system/NonCopyable.hpp"
+#include "system/StringId.hpp"
+#include "system/TimerWheel.hpp"
 #include "graphics/Animation.hpp"
+#include "controllers/AnimationSystem.hpp"
 
-class Animator
+// Handle to one instance of an AnimationSystem, which has to outlive it.
+// The clips are shared through the library of the system and advanced by AnimationSystem::update
+class Animator:
+	private NonCopyable
 {
 public:
 	struct Status
@@ -18,31 +24,34 @@ public:
 	};
 
 public:
-	Animator() noexcept;
+	Animator() noexcept; // Attaches to AnimationSystem::getInstance()
+	explicit Animator(AnimationSystem& system) noexcept;
 	~Animator();
 
-	bool addAnimation(const std::string& name, const Animation& anim) noexcept;
-	bool setAnimation(const std::string& name) noexcept;
+	bool addAnimation(const StringId& name, const Animation& anim) noexcept;
+	bool setAnimation(const StringId& name) noexcept;
 
-	void update(int dt)  noexcept;
 	void stop()          noexcept;
 	void play()          noexcept;
 	void loop(bool l)    noexcept;
 	void restart()       noexcept;
 	void reverse(bool r) noexcept;
 
-	const Sprite2D*  getCurrentFrame() const noexcept;
+	std::uint32_t    getCurrentFrame() const noexcept; // Index into the SpriteManager frame arena, or Animation::InvalidFrame
 	const Animation* getAnimation()    const noexcept;
-	const Status*    getStatus()       const noexcept;
+	Status           getStatus()       const noexcept;
 
-private:
-	std::unordered_map<std::string, Animation> m_animations;
+	AnimationSystem::Instance getInstance() const noexcept;
 
-	Animation m_currentAnimation;
-	int m_currentFrame;
-	int m_timer;
+//	Schedule the callback at every frame change, or at every end of the clip (once if it does not loop),
+//	instead of polling the status each frame. The wheel has to advance with the dt of the system; the timer
+//	follows the clip as it plays now, so cancel it when stopping, reversing or changing the clip
+	TimerWheel::TimerId scheduleFrameChange(TimerWheel& wheel, TimerWheel::Callback callback) const noexcept;
+	TimerWheel::TimerId scheduleClipEnd(TimerWheel& wheel, TimerWheel::Callback callback)     const noexcept;
 
-	Status m_status;
+private:
+	AnimationSystem*          m_system;
+	AnimationSystem::Instance m_instance;
 };
 
-#endif
\ No newline at end of file
+#endif
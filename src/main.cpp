@@ -1,20 +1,36 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <iostream>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include "system/Defines.hpp"
+#include "system/ThreadPool.hpp"
+#include "system/TimerWheel.hpp"
+#include "system/FileProvider.hpp"
+#include "graphics/Image.hpp"
 #include "graphics/Shader.hpp"
+#include "graphics/ShaderVariants.hpp"
+#include "graphics/UniformBuffer.hpp"
 #include "graphics/Transform2D.hpp"
+#include "graphics/TransformSystem.hpp"
+#include "graphics/SceneGraph.hpp"
 #include "graphics/Sprite2D.hpp"
+#include "graphics/SpriteBatch.hpp"
+#include "graphics/SpriteInstancer.hpp"
+#include "graphics/SpriteEffects.hpp"
+#include "graphics/RenderQueue.hpp"
 #include "graphics/TiledMap.hpp"
+#include "controllers/AnimationSystem.hpp"
 #include "controllers/Animator.hpp"
 
 #include "managers/AssetManager.hpp"
 #include "managers/SpriteManager.hpp"
 #include "managers/TiledMapManager.hpp"
+#include "managers/TiledMapStreamer.hpp"
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 bool IsKeyPressed(GLFWwindow* window, const int key);
@@ -71,11 +87,32 @@ int main()
     AssetManager al;
     SpriteManager sm;
     TiledMapManager tm;
+    AnimationSystem animations;
     Animator anim;
+    TimerWheel timers;
+
+//  The driver builds the programs while the textures and the map are loading
+    AssetManager::getAsync<Shader>("TileMap", "tilemap.vert", "tilemap.frag");
+    AssetManager::getAsync<Shader>("TileChunks", "tilemap_chunks.vert", "tilemap.frag");
+    AssetManager::getAsync<Shader>("TileIndices", "tilemap_indices.vert", "tilemap_indices.frag");
 
-    AssetManager::get<Texture2D>("Explosion.png");
+    ThreadPool recorders;
+
+//  The explosion frames are mostly transparent: their outlines are traced on every core from the image the texture
+//  is made of, before the upload
+    {
+        Image explosion;
+
+        if(const FileView file = FileProvider().getFileView("Explosion.png"); explosion.loadFromMemory(file.data(), file.size()))
+        {
+            SpriteManager::TrimOptions trim;
+            trim.image = &explosion;
+            trim.pool  = &recorders;
+
+            sm.createLinearAnimaton("Explosion", AssetManager::get<Texture2D>("Explosion.png", &explosion), 48, 1000 / 30, &trim);
+        }
+    }
 
-    sm.createLinearAnimaton("Explosion", AssetManager::get<Texture2D>("Explosion.png"), 48, 1000 / 30);
     sm.unloadOnGPU();
 
     auto tmp = tm.loadFromFile("Atreides8.tmx");
@@ -89,34 +126,121 @@ int main()
     anim.reverse(true);
     anim.play();
 
+//  Gameplay events are timers rather than counters polled every frame: the explosion turns around every 4 seconds
+    timers.schedule(4000U, [&anim](TimerWheel::TimerId) { anim.reverse(!anim.getStatus().isReversed); }, 4000U);
+
     Shader* tilemapShader = AssetManager::get<Shader>("TileMap", "tilemap.vert", "tilemap.frag");
     CheckExpr(tilemapShader);
-    Shader::bind(tilemapShader);
-    
-    int ViewProjection = tilemapShader->getUniformLocation("ViewProjection");
+
+//  The same layers drawn from their tile index textures (hold T), one quad per layer
+    Shader* tileIndicesShader = AssetManager::get<Shader>("TileIndices", "tilemap_indices.vert", "tilemap_indices.frag");
+    CheckExpr(tileIndicesShader);
+
+//  The same map saved as an infinite one, streamed around the view (hold N to see it instead).
+//  The chunks load on threads of their own, so a slow load never stalls the frame work on the recorders
+    ThreadPool loaders(2U);
+    TiledMapStreamer streamer(loaders);
+    CheckExpr(streamer.open("Atreides8_infinite.tmx"));
+
+    Shader* chunksShader = AssetManager::get<Shader>("TileChunks", "tilemap_chunks.vert", "tilemap.frag");
+    CheckExpr(chunksShader);
 
     glm::mat4 projection = glm::ortho(0.0f, (float)screen_size.x, (float)screen_size.y, 0.0f, -1.0f, 1.0f);
     ProjMatrix = &projection;
     Transform2D view;
 
-    glUniformMatrix4fv(ViewProjection, 1, GL_FALSE, glm::value_ptr(projection * view.getMatrix()));
+//  Written once per frame, read by every program through the FrameData block
+    UniformBuffer frameBuffer;
+    CheckExpr(frameBuffer.create(sizeof(FrameUniforms), FrameUniforms::Binding));
+    FrameUniforms frame;
+
+//  The sprite paths share one vertex/fragment pair, each variant is built with the #defines of its features
+    ShaderVariants spriteShaders;
+    CheckExpr(spriteShaders.create("batch.vert", "batch.frag", { "VERTEX_TINT", "INSTANCED" }));
+
+    Shader* batchShader = spriteShaders.get({ "VERTEX_TINT" });
+    CheckExpr(batchShader);
+
+    SpriteBatch batch;
+    CheckExpr(batch.create());
+
+    Shader* instancedShader = spriteShaders.get({ "VERTEX_TINT", "INSTANCED" });
+    CheckExpr(instancedShader);
+
+    SpriteInstancer instancer;
+    CheckExpr(instancer.create());
+
+    RenderQueue queue;
+
+//  A crowd of explosions over the map (hold C), recorded on every core and appended in chunk order
+    std::vector<SpriteBatch::CommandBuffer>     batchCommands(recorders.getThreadCount() + 1U);
+    std::vector<SpriteInstancer::CommandBuffer> instanceCommands(recorders.getThreadCount() + 1U);
+    std::vector<glm::vec2> crowd;
+
+    for (int y = 0; y < 64; ++y)
+        for (int x = 0; x < 64; ++x)
+            crowd.emplace_back(x * 48.0f, y * 48.0f);
+
+//  The same crowd animated by the GPU (hold G): spawned once with staggered start times, no CPU work per frame after that
+    ShaderVariants effectShaders;
+    CheckExpr(effectShaders.create("effects.vert", "batch.frag", { "VERTEX_TINT" }));
+
+    Shader* effectsShader = effectShaders.get({ "VERTEX_TINT" });
+    CheckExpr(effectsShader);
+
+    SpriteEffects effects;
+    CheckExpr(effects.create());
+    effects.setClips(animations);
+
+    {
+        const auto     clip   = animations.findClip("Explosion");
+        const Sprite2D sprite = sm.getSprite(animations.getClip(clip)->first);
+        const double   now    = glfwGetTime();
+
+        Transform2D transform;
+        transform.setOrigin(sprite.width * 0.5f, sprite.height * 0.5f)->setScale(0.25f);
 
-    Shader* spriteShader = AssetManager::get<Shader>("SpriteShader", "sprite.vert", "sprite.frag");
-    CheckExpr(spriteShader);
-    Shader::bind(spriteShader);
+        for(std::size_t i = 0; i < crowd.size(); ++i)
+        {
+            transform.setPosition(crowd[i])->setRotation(static_cast<float>(i));
+            effects.spawn(sprite.texture, clip, transform, now - i * 0.013, 1.0f, SpriteEffects::Looped | SpriteEffects::Reversed);
+        }
+    }
 
-    int ModelViewProjectionLoc = spriteShader->getUniformLocation("ModelViewProjection");
+//  The CPU crowd is placed through a TransformSystem: all the rotations change every frame and the affines are recomputed in SIMD blocks
+    TransformSystem                         crowdTransforms;
+    std::vector<TransformSystem::Transform> crowdHandles;
+
+    {
+        const Sprite2D sprite = sm.getSprite(anim.getCurrentFrame());
+
+        for(const auto& position : crowd)
+        {
+            const auto transform = crowdTransforms.create();
+            crowdTransforms.setPosition(transform, position.x, position.y);
+            crowdTransforms.setOrigin(transform, sprite.width * 0.5f, sprite.height * 0.5f);
+            crowdTransforms.setScale(transform, 0.25f, 0.25f);
+            crowdHandles.push_back(transform);
+        }
+    }
 
     int counter = 0;
     int frameNum = 0;
     int angle = 0;
 
-    Transform2D trans;
+//  The big explosion carries a smaller one around its center: the child follows the parent without matrices multiplied by hand
+    SceneGraph scene;
 
-    trans.setOrigin(128, 128);
-    trans.setPosition(200, 50);
+    const SceneGraph::Node carrier = scene.create();
+    scene.setOrigin(carrier, 128, 128);
+    scene.setPosition(carrier, 200, 50);
     //sprite.setScale(-1, 1);
 
+    const SceneGraph::Node satellite = scene.create(carrier);
+    scene.setOrigin(satellite, 128, 128);
+    scene.setPosition(satellite, 328, 128);
+    scene.setScale(satellite, 0.3f, 0.3f);
+
     int posX = 0;
     int posY = 0;
 
@@ -135,6 +259,8 @@ int main()
 
         dt = static_cast<int>(deltaTime * 1000);
 
+        AssetManager::update();
+
         glClearColor(0.6f, 0.8f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
@@ -150,33 +276,100 @@ int main()
         if(IsKeyPressed(window, GLFW_KEY_S))
             view.move(0, -10);
 
-        glm::mat4 viewProjMat { projection * view.getMatrix() }; 
+        frame.viewProjection = projection * view.getMatrix();
+        frame.viewportSize   = glm::vec2(screen_size);
+        frame.time           = effects.setTime(glfwGetTime()); // From the epoch of the effect clock
+        frameBuffer.update(frame);
+
+//      The tile layers keep their order through the depth, the sprites go on top. Only the chunks on screen are submitted
+        tm.setView(frame.viewProjection);
+        streamer.update(frame.viewProjection);
+
+        if(IsKeyPressed(window, GLFW_KEY_N))
+            streamer.submit(chunksShader, queue, 0);
+        else if(IsKeyPressed(window, GLFW_KEY_T))
+            for(std::size_t i = 0; i < tmp->m_layers.size(); ++i)
+                tm.submitTileIndices(tmp->m_layers[i], tileIndicesShader, queue, 0, static_cast<std::uint16_t>(i));
+        else
+            for(std::size_t i = 0; i < tmp->m_layers.size(); ++i)
+                tm.submit(tmp->m_layers[i], tilemapShader, queue, 0, static_cast<std::uint16_t>(i));
+
+        scene.setRotation(carrier, ugol);
+        scene.setRotation(satellite, -2.0f * ugol);
+        scene.update();
+        ugol += 2.5f;
 
-        Shader::bind(tilemapShader);
-        glUniformMatrix4fv(ViewProjection, 1, GL_FALSE, glm::value_ptr(viewProjMat));
+        animations.update(dt);
+        timers.advance(dt);
 
-        for(const auto& layer : tmp->m_layers)
-            tm.draw(layer);
+//      Hold I to draw through the instanced path
+        const bool isInstanced = IsKeyPressed(window, GLFW_KEY_I);
+        const bool hasCrowd    = IsKeyPressed(window, GLFW_KEY_C);
 
-        Shader::bind(nullptr);
+        if(hasCrowd)
+        {
+            const Sprite2D sprite = sm.getSprite(anim.getCurrentFrame());
 
-        trans.setRotation(ugol);
-        ugol += 2.5f;
+            for(std::size_t i = 0; i < crowdHandles.size(); ++i)
+                crowdTransforms.setRotation(crowdHandles[i], ugol + i);
+
+            crowdTransforms.update(recorders);
+
+            const auto& affines = crowdTransforms.getAffines();
+
+            recorders.parallelFor(affines.size(), [&](std::size_t chunk, std::size_t begin, std::size_t end)
+            {
+                batchCommands[chunk].clear();
+                batchCommands[chunk].setShader(batchShader);
+                instanceCommands[chunk].clear();
+
+                for(std::size_t i = begin; i < end; ++i)
+                {
+                    if(isInstanced)
+                        instanceCommands[chunk].draw(sprite, affines[i]);
+                    else
+                        batchCommands[chunk].draw(sprite, affines[i]);
+                }
+            });
+        }
+
+        const std::size_t chunks = hasCrowd ? recorders.getChunkCount(crowd.size()) : 0U;
 
-        anim.update(dt);
+        if(isInstanced)
+        {
+            instancer.begin(instancedShader);
+
+            for(std::size_t i = 0; i < chunks; ++i)
+                instancer.append(instanceCommands[i]);
+
+            instancer.draw(sm.getSprite(anim.getCurrentFrame()), scene.getWorldAffine(carrier));
+            instancer.draw(sm.getSprite(anim.getCurrentFrame()), scene.getWorldAffine(satellite));
+            instancer.end(queue, 1);
+        }
+        else
+        {
+            batch.begin(batchShader);
+
+            for(std::size_t i = 0; i < chunks; ++i)
+                batch.append(batchCommands[i]);
 
-        sm.bind(true);
-        Shader::bind(spriteShader);
+            batch.draw(sm.getSprite(anim.getCurrentFrame()), scene.getWorldAffine(carrier));
+            batch.draw(sm.getSprite(anim.getCurrentFrame()), scene.getWorldAffine(satellite));
+            batch.end(queue, 1);
+        }
 
-        glUniformMatrix4fv(ModelViewProjectionLoc, 1, GL_FALSE, glm::value_ptr(viewProjMat * trans.getMatrix()));
-        sm.draw(*anim.getCurrentFrame());
+        if(IsKeyPressed(window, GLFW_KEY_G))
+            effects.submit(effectsShader, queue, 1, 1);
 
-        Shader::bind(nullptr);
-        sm.bind(false);
+        queue.execute();
 
         glfwSwapBuffers(window);    
     }
 
+//  The chunk buffers and the tile map layers need the context
+    streamer.close();
+    tm.clear();
+
     glfwTerminate();
     return 0;
 }
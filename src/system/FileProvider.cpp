@@ -1,22 +1,302 @@
+#include "system/MappedFile.hpp"
+#include "system/ResourcePack.hpp"
 #include "system/FileProvider.hpp"
 
 #include <filesystem>
 #include <algorithm>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    struct ResourceIndex
+    {
+        struct Directory
+        {
+            fs::file_time_type       lastWriteTime;
+            std::vector<std::string> files; // Names of the files indexed from this directory
+        };
+
+        std::unordered_map<std::string, std::vector<std::string>> files;       // filename -> every path with this name
+        std::unordered_map<std::string, Directory>                directories; // directory -> its indexed state
+
+        std::shared_ptr<ResourcePack> pack;
+
+        FileProvider::Statistics stats;
+        std::string root;
+        std::mutex  mutex;
+        bool        isBuilt = false;
+
+        void build() noexcept
+        {
+            root = fs::current_path().string() + "/res";
+            std::replace(root.begin(), root.end(), '\\', '/');
+
+            scanDirectory(root);
+            isBuilt = true;
+
+            if (std::error_code ec; !pack && fs::exists(root + ".pak", ec))
+                mountPack(root + ".pak");
+        }
+
+        bool mountPack(const std::string& filepath) noexcept
+        {
+            auto newPack = std::make_shared<ResourcePack>();
+
+            if (!newPack->open(filepath))
+                return false;
+
+            pack = std::move(newPack); // Views into the previous pack keep it alive
+
+            return true;
+        }
+
+        const std::string* findLoose(const std::string& filename) noexcept
+        {
+            auto found = files.find(filename);
+
+            return (found != files.end()) ? &found->second.front() : nullptr;
+        }
+
+        void refresh() noexcept
+        {
+            std::vector<std::string> tracked;
+            tracked.reserve(directories.size());
+
+            for (const auto& [directory, state] : directories)
+                tracked.push_back(directory);
+
+            for (const auto& directory : tracked)
+            {
+                auto found = directories.find(directory);
+
+                if (found == directories.end())
+                    continue; // Dropped together with its parent
+
+                std::error_code ec;
+                auto lastWriteTime = fs::last_write_time(directory, ec);
+
+                if (ec)
+                {
+                    forgetDirectory(directory);
+                    continue;
+                }
+
+                if (lastWriteTime != found->second.lastWriteTime)
+                {
+                    unindexFiles(directory);
+                    directories.erase(found);
+                    scanDirectory(directory);
+                }
+            }
+
+            ++stats.refreshes;
+        }
+
+        void scanDirectory(const std::string& directory) noexcept
+        {
+            std::error_code ec;
+            auto& state = directories[directory];
+            state.lastWriteTime = fs::last_write_time(directory, ec);
+
+            for (auto it = fs::directory_iterator(directory, ec); !ec && it != fs::directory_iterator(); it.increment(ec))
+            {
+                std::string path = it->path().string();
+                std::replace(path.begin(), path.end(), '\\', '/');
+
+                if (it->is_directory(ec))
+                {
+                    if (directories.find(path) == directories.end())
+                        scanDirectory(path);
+                }
+                else if (it->is_regular_file(ec))
+                {
+                    std::string filename = it->path().filename().string();
+                    auto& paths = files[filename];
+                    paths.push_back(path);
+
+                    if (paths.size() == 2)
+                        ++stats.duplicates;
+
+                    if (paths.size() > 1)
+                        std::cerr << "Warning: duplicate resource name \"" << filename << "\", using " << paths.front() << '\n';
+
+                    directories[directory].files.push_back(std::move(filename));
+                }
+            }
+        }
+
+        void unindexFiles(const std::string& directory) noexcept
+        {
+            const std::string prefix = directory + '/';
+
+            for (const auto& filename : directories[directory].files)
+            {
+                auto found = files.find(filename);
+
+                if (found == files.end())
+                    continue;
+
+                auto& paths = found->second;
+                const bool wasDuplicate = paths.size() > 1;
+
+                paths.erase(std::remove_if(paths.begin(), paths.end(),
+                    [&prefix](const std::string& path)
+                    {
+                        return path.compare(0, prefix.size(), prefix) == 0 && path.find('/', prefix.size()) == std::string::npos;
+                    }), paths.end());
+
+                if (wasDuplicate && paths.size() < 2)
+                    --stats.duplicates;
+
+                if (paths.empty())
+                    files.erase(found);
+            }
+        }
+
+        void forgetDirectory(const std::string& directory) noexcept
+        {
+            const std::string prefix = directory + '/';
+
+            for (auto it = directories.begin(); it != directories.end();)
+            {
+                if (it->first == directory || it->first.compare(0, prefix.size(), prefix) == 0)
+                {
+                    unindexFiles(it->first);
+                    it = directories.erase(it);
+                }
+                else ++it;
+            }
+        }
+    };
+
+    ResourceIndex& getIndex() noexcept
+    {
+        static ResourceIndex index;
+
+        return index;
+    }
+}
 
 std::string FileProvider::getPathToFile(const std::string& filename) noexcept
 {   
-    static std::string resource_folder;
+    auto& index = getIndex();
+    std::lock_guard<std::mutex> lock(index.mutex);
+
+    auto start = std::chrono::steady_clock::now();
+
+    if ( ! index.isBuilt )
+        index.build();
+
+    auto found = index.files.find(filename);
+
+//  The file may have been added after the index was built
+    if (found == index.files.end())
+    {
+        index.refresh();
+        found = index.files.find(filename);
+    }
+
+    std::string filepath;
+
+    if (found != index.files.end())
+        filepath = found->second.front();
+    else
+        ++index.stats.misses;
+
+    ++index.stats.lookups;
+    index.stats.lookupTimeNs += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+    return filepath;
+}
+
+void FileProvider::refresh() noexcept
+{
+    auto& index = getIndex();
+    std::lock_guard<std::mutex> lock(index.mutex);
 
-    if (resource_folder.empty())  
-        resource_folder = std::filesystem::current_path().string() + "/res";    
-    
-    for (auto& file : std::filesystem::recursive_directory_iterator(resource_folder))
-        if (file.path().filename() == filename)
+    if (index.isBuilt)
+        index.refresh();
+    else
+        index.build();
+}
+
+std::vector<std::string> FileProvider::getDuplicates(const std::string& filename) noexcept
+{
+    auto& index = getIndex();
+    std::lock_guard<std::mutex> lock(index.mutex);
+
+    if (auto found = index.files.find(filename); found != index.files.end() && found->second.size() > 1)
+        return found->second;
+
+    return {};
+}
+
+FileView FileProvider::getFileView(const std::string& filename) noexcept
+{
+    auto& index = getIndex();
+    std::lock_guard<std::mutex> lock(index.mutex);
+
+    auto start = std::chrono::steady_clock::now();
+
+    if ( ! index.isBuilt )
+        index.build();
+
+    const std::string* filepath = index.findLoose(filename);
+    const ResourcePack::Entry* entry = nullptr;
+
+    if (!filepath)
+    {
+        if (index.pack)
+            entry = index.pack->find(filename);
+
+        if (!entry)
         {
-            std::string filepath = file.path().string();
-            std::replace(filepath.begin(), filepath.end(), '\\', '/');
-            return filepath;
+            index.refresh();
+            filepath = index.findLoose(filename);
         }
+    }
 
-    return {};
-}
\ No newline at end of file
+    FileView view;
+
+    if (filepath)
+    {
+        auto file = std::make_shared<MappedFile>();
+
+        if (file->open(*filepath))
+            view = FileView(file->data(), file->size(), file);
+    }
+    else if (entry)
+    {
+        view = index.pack->read(entry, index.pack);
+        ++index.stats.packHits;
+    }
+    else ++index.stats.misses;
+
+    ++index.stats.lookups;
+    index.stats.lookupTimeNs += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+    return view;
+}
+
+bool FileProvider::mountPack(const std::string& filepath) noexcept
+{
+    auto& index = getIndex();
+    std::lock_guard<std::mutex> lock(index.mutex);
+
+    return index.mountPack(filepath);
+}
+
+FileProvider::Statistics FileProvider::getStatistics() noexcept
+{
+    auto& index = getIndex();
+    std::lock_guard<std::mutex> lock(index.mutex);
+
+    index.stats.files = index.files.size();
+
+    return index.stats;
+}
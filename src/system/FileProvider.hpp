@@ -2,10 +2,37 @@
 #define FILE_PROVIDER_HPP
 
 #include <string>
+#include <vector>
+#include <cstdint>
+
+#include "system/FileView.hpp"
 
 struct FileProvider
 {
+    struct Statistics
+    {
+        std::uint64_t lookups      = 0U; // Number of getPathToFile calls
+        std::uint64_t misses       = 0U; // Lookups that found nothing even after a refresh
+        std::uint64_t packHits     = 0U; // Views served from the mounted resource pack
+        std::uint64_t refreshes    = 0U; // Number of incremental index refreshes
+        std::uint64_t lookupTimeNs = 0U; // Total time spent inside getPathToFile
+        std::size_t   files        = 0U; // Indexed file names
+        std::size_t   duplicates   = 0U; // File names found in more than one directory
+    };
+
     std::string getPathToFile(const std::string& filename) noexcept;
+
+//  Loose files under res/ take precedence over the entries of the mounted pack
+    FileView getFileView(const std::string& filename) noexcept;
+
+//  res.pak next to the working directory is mounted automatically
+    bool mountPack(const std::string& filepath) noexcept;
+
+//  Rescans only the directories whose modification time has changed since the last scan
+    void refresh() noexcept;
+
+    std::vector<std::string> getDuplicates(const std::string& filename) noexcept;
+    Statistics getStatistics() noexcept;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,54 @@
+#ifndef FILE_VIEW_HPP
+#define FILE_VIEW_HPP
+
+#include <memory>
+#include <cstddef>
+
+// Read-only window onto the contents of a resource.
+// The owner keeps the underlying memory (mapping, pack or decompressed buffer) alive.
+class FileView
+{
+public:
+    FileView() noexcept;
+    FileView(const char* data, std::size_t size, std::shared_ptr<const void> owner) noexcept;
+
+    const char* data()  const noexcept;
+    std::size_t size()  const noexcept;
+    bool        empty() const noexcept;
+
+private:
+    std::shared_ptr<const void> m_owner;
+    const char* m_data;
+    std::size_t m_size;
+};
+
+inline FileView::FileView() noexcept:
+    m_owner(),
+    m_data(nullptr),
+    m_size(0U)
+{
+}
+
+inline FileView::FileView(const char* data, std::size_t size, std::shared_ptr<const void> owner) noexcept:
+    m_owner(std::move(owner)),
+    m_data(data),
+    m_size(size)
+{
+}
+
+inline const char* FileView::data() const noexcept
+{
+    return m_data;
+}
+
+inline std::size_t FileView::size() const noexcept
+{
+    return m_size;
+}
+
+inline bool FileView::empty() const noexcept
+{
+    return m_data == nullptr;
+}
+
+#endif // !FILE_VIEW_HPP
@@ -0,0 +1,33 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+
+#include "system/NonCopyable.hpp"
+
+// Read-only memory mapping of a whole file
+class MappedFile:
+    private NonCopyable
+{
+public:
+    MappedFile() noexcept;
+    ~MappedFile();
+
+    bool open(const std::string& filepath) noexcept;
+    void close() noexcept;
+
+    const char* data() const noexcept;
+    std::size_t size() const noexcept;
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#endif
+};
+
+#endif // !MAPPED_FILE_HPP
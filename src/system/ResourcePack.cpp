@@ -0,0 +1,104 @@
+#include <iostream>
+#include <vector>
+
+#include <stb_image.h>
+
+#include "system/ResourcePack.hpp"
+
+ResourcePack::ResourcePack() noexcept
+{
+}
+
+ResourcePack::~ResourcePack()
+{
+}
+
+bool ResourcePack::open(const std::string& filepath) noexcept
+{
+    m_entries.clear();
+
+    if (!m_file.open(filepath))
+        return false;
+
+    const char*       base = m_file.data();
+    const std::size_t size = m_file.size();
+
+    if (size < sizeof(Header))
+    {
+        m_file.close();
+        return false;
+    }
+
+    const auto header = reinterpret_cast<const Header*>(base);
+
+    const bool isValid = (header->magic == Magic) &&
+                         (header->version == Version) &&
+                         (header->tocOffset + sizeof(Entry) * header->entryCount <= size) &&
+                         (header->namesOffset <= size);
+
+    if (!isValid)
+    {
+        std::cerr << "Error: " << filepath << " is not a valid resource pack\n";
+        m_file.close();
+
+        return false;
+    }
+
+    const auto entries = reinterpret_cast<const Entry*>(base + header->tocOffset);
+    const char* names  = base + header->namesOffset;
+
+    m_entries.reserve(header->entryCount);
+
+    for (std::uint32_t i = 0; i < header->entryCount; ++i)
+    {
+        const Entry& entry = entries[i];
+
+        if (entry.offset + entry.size > size || header->namesOffset + entry.nameOffset + entry.nameLength > size)
+            continue;
+
+        std::string name(names + entry.nameOffset, entry.nameLength);
+
+        if (std::size_t last_slash_pos = name.find_last_of('/'); last_slash_pos != std::string::npos)
+            name.erase(0, last_slash_pos + 1);
+
+        if (!m_entries.try_emplace(std::move(name), &entry).second)
+            std::cerr << "Warning: duplicate resource name in pack: " << std::string(names + entry.nameOffset, entry.nameLength) << '\n';
+    }
+
+    return true;
+}
+
+const ResourcePack::Entry* ResourcePack::find(const std::string& filename) const noexcept
+{
+    auto found = m_entries.find(filename);
+
+    return (found != m_entries.end()) ? found->second : nullptr;
+}
+
+FileView ResourcePack::read(const Entry* entry, const std::shared_ptr<const void>& owner) const noexcept
+{
+    if (!entry)
+        return {};
+
+    const char* data = m_file.data() + entry->offset;
+
+    if ( ! (entry->flags & Compressed) )
+        return FileView(data, static_cast<std::size_t>(entry->size), owner);
+
+    auto buffer = std::make_shared<std::vector<char>>(static_cast<std::size_t>(entry->originalSize));
+
+    int length = stbi_zlib_decode_buffer(buffer->data(), static_cast<int>(buffer->size()), data, static_cast<int>(entry->size));
+
+    if (length != static_cast<int>(buffer->size()))
+    {
+        std::cerr << "Error: corrupted compressed entry in resource pack\n";
+        return {};
+    }
+
+    return FileView(buffer->data(), buffer->size(), buffer);
+}
+
+std::size_t ResourcePack::getEntryCount() const noexcept
+{
+    return m_entries.size();
+}
@@ -0,0 +1,68 @@
+#ifndef RESOURCE_PACK_HPP
+#define RESOURCE_PACK_HPP
+
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+#include "system/NonCopyable.hpp"
+#include "system/MappedFile.hpp"
+#include "system/FileView.hpp"
+
+// Packed resource archive, memory mapped as a whole.
+// Layout: [Header][aligned entry data ...][Entry table][name table]
+class ResourcePack:
+    private NonCopyable
+{
+public:
+    static constexpr std::uint32_t Magic   = 0x4B415052; // "RPAK"
+    static constexpr std::uint32_t Version = 1U;
+
+    enum Flags : std::uint32_t
+    {
+        Compressed = 1U << 0 // Data is a zlib stream of originalSize bytes
+    };
+
+    struct Header
+    {
+        std::uint32_t magic      = Magic;
+        std::uint32_t version    = Version;
+        std::uint32_t entryCount = 0U;
+        std::uint32_t alignment  = 0U;  // Alignment of every entry's data
+        std::uint64_t tocOffset  = 0U;  // Offset of the Entry table
+        std::uint64_t namesOffset = 0U; // Offset of the name table
+    };
+
+    struct Entry
+    {
+        std::uint64_t offset       = 0U; // Offset of the data from the start of the pack
+        std::uint64_t size         = 0U; // Stored size
+        std::uint64_t originalSize = 0U; // Size after decompression
+        std::uint32_t nameOffset   = 0U; // Offset in the name table
+        std::uint32_t nameLength   = 0U; // Path relative to res/, without terminator
+        std::uint32_t flags        = 0U;
+        std::uint32_t reserved     = 0U;
+    };
+
+    static_assert(sizeof(Header) == 32, "ResourcePack::Header must stay 32 bytes");
+    static_assert(sizeof(Entry)  == 40, "ResourcePack::Entry must stay 40 bytes");
+
+public:
+    ResourcePack() noexcept;
+    ~ResourcePack();
+
+    bool open(const std::string& filepath) noexcept;
+
+    const Entry* find(const std::string& filename) const noexcept;
+
+//  Uncompressed entries are returned without a copy; the view keeps the pack alive through owner
+    FileView read(const Entry* entry, const std::shared_ptr<const void>& owner) const noexcept;
+
+    std::size_t getEntryCount() const noexcept;
+
+private:
+    MappedFile m_file;
+    std::unordered_map<std::string, const Entry*> m_entries; // filename -> entry
+};
+
+#endif // !RESOURCE_PACK_HPP
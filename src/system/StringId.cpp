@@ -0,0 +1,55 @@
+#include <unordered_map>
+#include <mutex>
+#include <iostream>
+
+#include "system/StringId.hpp"
+
+namespace
+{
+    struct StringTable
+    {
+        std::unordered_map<std::uint64_t, std::string> names; // Nodes never move, so c_str() stays valid
+        std::mutex mutex;
+    };
+
+    StringTable& getStringTable() noexcept
+    {
+        static StringTable table;
+
+        return table;
+    }
+}
+
+StringId::StringId(const std::string& name) noexcept:
+    m_hash(hash(name.c_str())),
+    m_name(intern(m_hash, name.c_str()))
+{
+}
+
+const char* StringId::intern(std::uint64_t hash, const char* name) noexcept
+{
+    auto& table = getStringTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    auto [iterator, result] = table.names.try_emplace(hash, name);
+
+#ifdef DEBUG
+    if (!result && iterator->second != name)
+        std::cerr << "Error: StringId hash collision between \"" << iterator->second << "\" and \"" << name << "\"\n";
+#endif
+
+    return iterator->second.c_str();
+}
+
+StringId StringId::fromHash(std::uint64_t hash) noexcept
+{
+#ifdef DEBUG
+    auto& table = getStringTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    if (auto found = table.names.find(hash); found != table.names.end())
+        return StringId(hash, found->second.c_str());
+#endif
+
+    return StringId(hash, "");
+}
@@ -0,0 +1,128 @@
+#ifndef STRING_ID_HPP
+#define STRING_ID_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+// Debug builds intern literals as well, so fromHash can recover every name
+#ifdef DEBUG
+#define STRING_ID_LITERAL_CONSTEXPR
+#else
+#define STRING_ID_LITERAL_CONSTEXPR constexpr
+#endif
+
+// Hashed name. Comparing and hashing ids is an integer operation.
+// String literals are hashed at compile time and keep a pointer to the literal, so only literals, or constant
+// arrays that live as long as the program, may take that path. Writable buffers and runtime names are interned
+// in a global string table, so the name pointer always stays valid.
+class StringId
+{
+public:
+    constexpr StringId() noexcept;
+
+    template<std::size_t N>
+    STRING_ID_LITERAL_CONSTEXPR StringId(const char (&literal)[N]) noexcept;
+
+//  A writable array is never a literal and may go away with its scope
+    template<std::size_t N>
+    StringId(char (&buffer)[N]) noexcept;
+
+    StringId(const std::string& name) noexcept;
+
+//  In debug builds the name is recovered from the string table
+    static StringId fromHash(std::uint64_t hash) noexcept;
+
+    static constexpr std::uint64_t hash(const char* str) noexcept;
+
+    constexpr std::uint64_t getHash() const noexcept;
+    constexpr const char*   c_str()   const noexcept;
+
+private:
+    constexpr StringId(std::uint64_t hash, const char* name) noexcept;
+
+//  The copy of the name in the string table
+    static const char* intern(std::uint64_t hash, const char* name) noexcept;
+
+private:
+    std::uint64_t m_hash;
+    const char*   m_name;
+};
+
+constexpr StringId::StringId() noexcept:
+    m_hash(0U),
+    m_name("")
+{
+}
+
+template<std::size_t N>
+STRING_ID_LITERAL_CONSTEXPR StringId::StringId(const char (&literal)[N]) noexcept:
+    m_hash(hash(literal)),
+    m_name(literal)
+{
+#ifdef DEBUG
+    m_name = intern(m_hash, literal);
+#endif
+}
+
+template<std::size_t N>
+StringId::StringId(char (&buffer)[N]) noexcept:
+    m_hash(hash(buffer)),
+    m_name(intern(m_hash, buffer))
+{
+}
+
+constexpr StringId::StringId(std::uint64_t hash, const char* name) noexcept:
+    m_hash(hash),
+    m_name(name)
+{
+}
+
+// 64-bit FNV-1a
+constexpr std::uint64_t StringId::hash(const char* str) noexcept
+{
+    std::uint64_t result = 14695981039346656037ULL;
+
+    while (*str)
+    {
+        result ^= static_cast<unsigned char>(*str++);
+        result *= 1099511628211ULL;
+    }
+
+    return result;
+}
+
+constexpr std::uint64_t StringId::getHash() const noexcept
+{
+    return m_hash;
+}
+
+constexpr const char* StringId::c_str() const noexcept
+{
+    return m_name;
+}
+
+constexpr bool operator ==(const StringId& a, const StringId& b) noexcept
+{
+    return a.getHash() == b.getHash();
+}
+
+constexpr bool operator !=(const StringId& a, const StringId& b) noexcept
+{
+    return a.getHash() != b.getHash();
+}
+
+namespace std
+{
+    template<>
+    struct hash<StringId>
+    {
+        std::size_t operator()(const StringId& id) const noexcept
+        {
+            return static_cast<std::size_t>(id.getHash());
+        }
+    };
+}
+
+#endif // !STRING_ID_HPP
@@ -0,0 +1,103 @@
+#include <algorithm>
+
+#include "system/ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned threadCount) noexcept:
+    m_isRunning(true)
+{
+//  hardware_concurrency() may return 0 when the count is unknown
+    if (threadCount == 0U)
+    {
+        const unsigned hw = std::thread::hardware_concurrency();
+        threadCount = (hw > 1U) ? hw - 1U : 1U;
+    }
+
+    m_threads.reserve(threadCount);
+
+    for (unsigned i = 0U; i < threadCount; ++i)
+        m_threads.emplace_back(&ThreadPool::run, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isRunning = false;
+    }
+
+    m_condition.notify_all();
+
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void ThreadPool::push(std::function<void()> task) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(task));
+    }
+
+    m_condition.notify_one();
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t chunk, std::size_t begin, std::size_t end)>& task) noexcept
+{
+    const std::size_t chunks = getChunkCount(count);
+
+    if (chunks == 0U)
+        return;
+
+    std::mutex              mutex;
+    std::condition_variable condition;
+    std::size_t             remaining = chunks - 1U;
+
+    for (std::size_t chunk = 1U; chunk < chunks; ++chunk)
+    {
+        push([&, chunk]
+        {
+            task(chunk, count * chunk / chunks, count * (chunk + 1U) / chunks);
+
+//          Notified under the lock: the caller may return and destroy the condition as soon as it sees zero
+            std::lock_guard<std::mutex> lock(mutex);
+            --remaining;
+            condition.notify_one();
+        });
+    }
+
+    task(0U, 0U, count / chunks);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&remaining] { return remaining == 0U; });
+}
+
+std::size_t ThreadPool::getChunkCount(std::size_t count) const noexcept
+{
+    return std::min(count, m_threads.size() + 1U);
+}
+
+unsigned ThreadPool::getThreadCount() const noexcept
+{
+    return static_cast<unsigned>(m_threads.size());
+}
+
+void ThreadPool::run() noexcept
+{
+    for (;;)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return !m_isRunning || !m_tasks.empty(); });
+
+            if (!m_isRunning && m_tasks.empty())
+                return; // Pending tasks are finished before the pool shuts down
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        task();
+    }
+}
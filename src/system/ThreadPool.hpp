@@ -0,0 +1,41 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "system/NonCopyable.hpp"
+
+class ThreadPool:
+    private NonCopyable
+{
+public:
+    explicit ThreadPool(unsigned threadCount = 0U) noexcept; // 0 - one thread per core, except the calling one
+    ~ThreadPool();
+
+    void push(std::function<void()> task) noexcept;
+
+//  Splits [0, count) into getChunkCount(count) contiguous ranges and blocks until every range is done.
+//  The calling thread takes the first range. The ranges only depend on count and on the size of the pool,
+//  so results written per chunk can be merged in chunk order deterministically
+    void parallelFor(std::size_t count, const std::function<void(std::size_t chunk, std::size_t begin, std::size_t end)>& task) noexcept;
+
+    std::size_t getChunkCount(std::size_t count) const noexcept;
+    unsigned    getThreadCount() const noexcept;
+
+private:
+    void run() noexcept;
+
+private:
+    std::vector<std::thread>          m_threads;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex                        m_mutex;
+    std::condition_variable           m_condition;
+    bool                              m_isRunning;
+};
+
+#endif // !THREAD_POOL_HPP
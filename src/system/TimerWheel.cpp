@@ -0,0 +1,275 @@
+#include <algorithm>
+
+#include "system/TimerWheel.hpp"
+
+TimerWheel::TimerWheel(unsigned tickLength) noexcept:
+    m_occupied(0U),
+    m_now(0U),
+    m_tickLength(std::max(tickLength, 1U)),
+    m_remainder(0)
+{
+    std::fill(m_heads, m_heads + ListCount, Null);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(std::uint64_t delay, Callback callback, std::uint64_t period) noexcept
+{
+    if(!callback)
+        return InvalidTimer;
+
+    std::uint32_t index;
+
+    if(!m_freeTimers.empty())
+    {
+        index = m_freeTimers.back();
+        m_freeTimers.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(m_timers.size());
+        m_timers.emplace_back();
+    }
+
+//  Rounded up, and at least one tick: the slot of the current tick has already fired
+    const std::uint64_t ticks = std::max<std::uint64_t>((delay + m_tickLength - 1U) / m_tickLength, 1U);
+
+    Timer& timer   = m_timers[index];
+    timer.callback = std::move(callback);
+    timer.expiry   = m_now + ticks;
+    timer.period   = period ? std::max<std::uint64_t>((period + m_tickLength - 1U) / m_tickLength, 1U) : 0U;
+
+    insert(index);
+
+    ++m_statistics.active;
+    ++m_statistics.scheduled;
+
+    return (std::uint64_t(timer.generation) << 32) | index;
+}
+
+bool TimerWheel::cancel(TimerId timer) noexcept
+{
+    const std::uint32_t index = getIndex(timer);
+
+    if(index == Null)
+        return false;
+
+    unlink(index);
+    release(index);
+
+    ++m_statistics.cancelled;
+
+    return true;
+}
+
+void TimerWheel::advance(int dt) noexcept
+{
+    if(dt <= 0)
+        return;
+
+    m_remainder += dt;
+
+    const std::uint64_t target = m_now + static_cast<std::uint64_t>(m_remainder) / m_tickLength;
+    m_remainder %= static_cast<int>(m_tickLength);
+
+    while(m_now < target)
+    {
+        if(m_statistics.active == 0U)
+        {
+            m_now = target;
+            break;
+        }
+
+//      The next tick with work is either an occupied slot later in this round of the first level,
+//      or the end of the round, where the upper levels cascade down
+        const unsigned current = static_cast<unsigned>(m_now & (SlotCount - 1U));
+        std::uint64_t  next    = ((m_now >> SlotBits) + 1U) << SlotBits;
+
+        for(unsigned slot = current + 1U; slot < SlotCount; ++slot)
+        {
+            if(m_occupied & (std::uint64_t(1) << slot))
+            {
+                next = m_now - current + slot;
+                break;
+            }
+        }
+
+        if(next > target)
+        {
+            m_now = target;
+            break;
+        }
+
+        m_now = next - 1U;
+        tick();
+    }
+}
+
+std::uint64_t TimerWheel::getTime() const noexcept
+{
+    return m_now;
+}
+
+bool TimerWheel::isPending(TimerId timer) const noexcept
+{
+    return getIndex(timer) != Null;
+}
+
+const TimerWheel::Statistics& TimerWheel::getStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+void TimerWheel::tick() noexcept
+{
+    ++m_now;
+
+//  The upper levels go first, so what they hand down for this round is in place before the lower ones cascade
+    unsigned levels = 0U;
+
+    while(levels + 1U < Levels && (m_now & ((std::uint64_t(1) << (SlotBits * (levels + 1U))) - 1U)) == 0U)
+        ++levels;
+
+    for(unsigned level = levels; level > 0U; --level)
+        cascade(level);
+
+//  Detached first, so callbacks can cancel any timer of the slot or schedule new ones
+    const auto slot = static_cast<std::uint32_t>(m_now & (SlotCount - 1U));
+
+    while(m_heads[slot] != Null)
+    {
+        const std::uint32_t index = m_heads[slot];
+
+        unlink(index);
+        link(index, FiringList);
+    }
+
+    while(m_heads[FiringList] != Null)
+    {
+        const std::uint32_t index = m_heads[FiringList];
+        const TimerId       id    = (std::uint64_t(m_timers[index].generation) << 32) | index;
+
+        unlink(index);
+
+        ++m_statistics.fired;
+
+//      The callback is moved out: it may schedule timers and reallocate the pool, or cancel its own timer
+        Callback callback = std::move(m_timers[index].callback);
+
+        if(m_timers[index].period)
+        {
+            m_timers[index].expiry = m_now + m_timers[index].period;
+            insert(index);
+
+            callback(id);
+
+            if(getIndex(id) == index)
+                m_timers[index].callback = std::move(callback);
+        }
+        else
+        {
+            release(index);
+            callback(id);
+        }
+    }
+}
+
+void TimerWheel::cascade(unsigned level) noexcept
+{
+    const auto list = static_cast<std::uint32_t>(level * SlotCount + ((m_now >> (SlotBits * level)) & (SlotCount - 1U)));
+
+    for(std::uint32_t index = m_heads[list]; index != Null; )
+    {
+        const std::uint32_t next = m_timers[index].next;
+
+        unlink(index);
+        insert(index);
+
+        ++m_statistics.cascaded;
+        index = next;
+    }
+}
+
+void TimerWheel::insert(std::uint32_t index) noexcept
+{
+    const std::uint64_t expiry = m_timers[index].expiry;
+    const std::uint64_t delta  = (expiry > m_now) ? expiry - m_now : 0U;
+
+    if(delta < SlotCount)
+    {
+        link(index, static_cast<std::uint32_t>(expiry & (SlotCount - 1U)));
+
+        return;
+    }
+
+    for(unsigned level = 1U; level < Levels; ++level)
+    {
+        if(delta < (std::uint64_t(1) << (SlotBits * (level + 1U))) || level + 1U == Levels)
+        {
+//          Beyond the last level the timer waits in its farthest slot and is placed again when it cascades
+            const std::uint64_t horizon = (std::uint64_t(1) << (SlotBits * Levels)) - 1U;
+            const std::uint64_t tick    = std::min(expiry, m_now + horizon);
+
+            link(index, static_cast<std::uint32_t>(level * SlotCount + ((tick >> (SlotBits * level)) & (SlotCount - 1U))));
+
+            return;
+        }
+    }
+}
+
+void TimerWheel::link(std::uint32_t index, std::uint32_t list) noexcept
+{
+    Timer& timer = m_timers[index];
+
+    timer.list     = list;
+    timer.previous = Null;
+    timer.next     = m_heads[list];
+
+    if(timer.next != Null)
+        m_timers[timer.next].previous = index;
+
+    m_heads[list] = index;
+
+    if(list < SlotCount)
+        m_occupied |= std::uint64_t(1) << list;
+}
+
+void TimerWheel::unlink(std::uint32_t index) noexcept
+{
+    Timer& timer = m_timers[index];
+
+    if(timer.previous != Null)
+        m_timers[timer.previous].next = timer.next;
+    else
+        m_heads[timer.list] = timer.next;
+
+    if(timer.next != Null)
+        m_timers[timer.next].previous = timer.previous;
+
+    if(timer.list < SlotCount && m_heads[timer.list] == Null)
+        m_occupied &= ~(std::uint64_t(1) << timer.list);
+
+    timer.previous = Null;
+    timer.next     = Null;
+}
+
+void TimerWheel::release(std::uint32_t index) noexcept
+{
+    Timer& timer = m_timers[index];
+
+    timer.callback = nullptr;
+    timer.list     = Null;
+    ++timer.generation;
+
+    m_freeTimers.push_back(index);
+    --m_statistics.active;
+}
+
+std::uint32_t TimerWheel::getIndex(TimerId timer) const noexcept
+{
+    const auto index      = static_cast<std::uint32_t>(timer);
+    const auto generation = static_cast<std::uint32_t>(timer >> 32);
+
+    if(index >= m_timers.size() || m_timers[index].generation != generation || m_timers[index].list == Null)
+        return Null;
+
+    return index;
+}
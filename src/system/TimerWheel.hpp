@@ -0,0 +1,90 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+#include "system/NonCopyable.hpp"
+
+// Hierarchical timing wheel with a resolution of one tick (a millisecond by default).
+// Levels hold SlotCount slots each, level n covering SlotCount^(n + 1) ticks; a timer waits in the level
+// of its distance and moves down a level each time the level below wraps around, so a timer is touched
+// at most Levels times before it fires. Timers are intrusive lists in a pool: schedule and cancel are O(1),
+// and advance only visits the slots passed over, skipping empty stretches of the first level with a bitmask.
+// Callbacks run inside advance() and may schedule or cancel timers, themselves included
+class TimerWheel:
+    private NonCopyable
+{
+public:
+    using TimerId  = std::uint64_t; // Index in the low half, generation in the high half
+    using Callback = std::function<void(TimerId)>;
+
+    static constexpr TimerId InvalidTimer = 0U;
+
+    static constexpr unsigned SlotBits  = 6U;
+    static constexpr unsigned SlotCount = 1U << SlotBits;
+    static constexpr unsigned Levels    = 4U; // SlotCount^Levels ticks ahead; later timers wait at the top level
+
+    struct Statistics
+    {
+        std::uint32_t active    = 0U;
+        std::uint64_t scheduled = 0U;
+        std::uint64_t cancelled = 0U;
+        std::uint64_t fired     = 0U;
+        std::uint64_t cascaded  = 0U; // Timers moved down a level
+    };
+
+public:
+    explicit TimerWheel(unsigned tickLength = 1U) noexcept; // In milliseconds
+
+//  Fires after delay milliseconds, rounded up to a tick, then every period milliseconds if period is not 0
+    TimerId schedule(std::uint64_t delay, Callback callback, std::uint64_t period = 0U) noexcept;
+    bool    cancel(TimerId timer) noexcept; // false if the timer has already fired or was cancelled
+
+//  Moves the clock forward by dt milliseconds and runs the callbacks of the timers due, in order of expiry
+    void advance(int dt) noexcept;
+
+    std::uint64_t     getTime() const noexcept; // Ticks since construction
+    bool              isPending(TimerId timer) const noexcept;
+    const Statistics& getStatistics() const noexcept;
+
+private:
+    static constexpr std::uint32_t Null        = UINT32_MAX;
+    static constexpr std::uint32_t FiringList  = Levels * SlotCount;
+    static constexpr std::uint32_t ListCount   = FiringList + 1U;
+
+    struct Timer
+    {
+        Callback      callback;
+        std::uint64_t expiry     = 0U; // Absolute tick
+        std::uint64_t period     = 0U; // In ticks
+        std::uint32_t previous   = Null;
+        std::uint32_t next       = Null;
+        std::uint32_t list       = Null; // Slot the timer is linked into, Null when free
+        std::uint32_t generation = 1U;
+    };
+
+    void tick() noexcept;
+    void cascade(unsigned level) noexcept;
+    void insert(std::uint32_t index) noexcept;
+    void link(std::uint32_t index, std::uint32_t list) noexcept;
+    void unlink(std::uint32_t index) noexcept;
+    void release(std::uint32_t index) noexcept;
+
+    std::uint32_t getIndex(TimerId timer) const noexcept; // Null if the id is stale
+
+private:
+    std::vector<Timer>         m_timers;
+    std::vector<std::uint32_t> m_freeTimers;
+    std::uint32_t              m_heads[ListCount];
+    std::uint64_t              m_occupied; // One bit per non-empty slot of the first level
+
+    std::uint64_t m_now;       // In ticks
+    unsigned      m_tickLength;
+    int           m_remainder; // Milliseconds not yet making a tick
+
+    Statistics m_statistics;
+};
+
+#endif // !TIMER_WHEEL_HPP
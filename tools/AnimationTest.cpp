@@ -0,0 +1,136 @@
+// Plays clips through AnimationSystem::update with a fixed dt and checks every update against the closed form
+// of the playback: Animation::getFrameAt and SpriteEffects::getFrame, the CPU mirror of animation.glsl.
+// The delays are taken both divisible and not by dt, looped and not, forward and reversed.
+// The SpriteEffects mirror is also played 100 hours into the clock, through the epochs setTime rebases to.
+// Returns the number of failed runs, run by ctest as animation_timing.
+
+#include <iostream>
+#include <string>
+#include <cmath>
+
+#include "graphics/Animation.hpp"
+#include "graphics/SpriteEffects.hpp"
+#include "controllers/AnimationSystem.hpp"
+
+namespace
+{
+    struct Case
+    {
+        unsigned duration;
+        unsigned delay;
+        int      dt;
+    };
+
+//  dt divides the delay, does not, is larger than it, or spans several frames per update
+    constexpr Case Cases[] =
+    {
+        { 8U, 100U, 10 },
+        { 8U, 100U, 7 },
+        { 8U, 100U, 100 },
+        { 8U, 100U, 250 },
+        { 5U, 16U, 33 },
+        { 5U, 33U, 16 },
+        { 1U, 50U, 20 },
+        { 3U, 1U, 1 },
+        { 6U, 40U, 300 },
+        { 60U, 70U, 1 } // Long enough for seconds * 1000 to fall short of whole milliseconds
+    };
+
+//  Where a float of absolute seconds is 31 ms coarse. Rebased every RebaseStep ms of the clip, first from an
+//  epoch before the start
+    constexpr double LateStart  = 360000.123;
+    constexpr int    RebaseStep = 777;
+
+    bool run(AnimationSystem& system, AnimationSystem::ClipId clipId, const Case& test, bool isLooped, bool isReversed) noexcept
+    {
+        const Animation& clip     = *system.getClip(clipId);
+        const int        period   = static_cast<int>(clip.duration * clip.delay);
+        const auto       instance = system.create(clipId);
+
+        system.setFlag(instance, AnimationSystem::Looped, isLooped);
+        system.setFlag(instance, AnimationSystem::Reversed, isReversed);
+        system.restart(instance);
+
+        SpriteEffects::Effect effect {};
+        effect.rate  = 1.0f;
+        effect.flags = (isLooped ? SpriteEffects::Looped : 0U) | (isReversed ? SpriteEffects::Reversed : 0U);
+
+        auto fail = [&](int elapsed, const char* what, long long actual, long long expected)
+        {
+            std::cerr << "FAIL duration " << test.duration << ", delay " << test.delay << ", dt " << test.dt
+                      << (isLooped ? ", looped" : "") << (isReversed ? ", reversed" : "") << " at " << elapsed << " ms: "
+                      << what << ' ' << actual << ", expected " << expected << '\n';
+
+            system.destroy(instance);
+
+            return false;
+        };
+
+//      Two full clips and then some, so the wraps and the end are crossed
+        for(int elapsed = 0; elapsed <= 2 * period + 3 * test.dt; elapsed += test.dt)
+        {
+            if(elapsed > 0)
+                system.update(test.dt);
+
+            const std::uint32_t frame    = system.getCurrentFrame(instance);
+            const std::uint32_t expected = clip.getFrameAt(static_cast<float>(elapsed), isLooped, isReversed);
+            const std::uint32_t mirrored = SpriteEffects::getFrame(clip, effect, static_cast<float>(elapsed) / 1000.0f);
+
+            if(frame != expected)
+                return fail(elapsed, "frame", frame, expected);
+
+            if(mirrored != expected)
+                return fail(elapsed, "SpriteEffects frame", mirrored, expected);
+
+            const double now   = LateStart + elapsed / 1000.0;
+            const double epoch = (elapsed < RebaseStep) ? LateStart - 30.0 : LateStart + (elapsed - elapsed % RebaseStep) / 1000.0;
+
+            SpriteEffects::Effect late = effect;
+            late.start = static_cast<float>(SpriteEffects::rebaseStart(clip, late, LateStart, epoch) - epoch);
+
+            const std::uint32_t lateFrame = SpriteEffects::getFrame(clip, late, static_cast<float>(now - epoch));
+
+            if(lateFrame != expected)
+                return fail(elapsed, "SpriteEffects frame late in the clock", lateFrame, expected);
+
+//          The waits the timer wheel is scheduled with
+            const bool isOver      = !isLooped && elapsed >= period;
+            const int  toNextFrame = isOver ? -1 : static_cast<int>(clip.delay) - elapsed % static_cast<int>(clip.delay);
+            const int  toEnd       = isOver ? -1 : period - elapsed % period;
+
+            if(system.getTimeToNextFrame(instance) != toNextFrame)
+                return fail(elapsed, "time to next frame", system.getTimeToNextFrame(instance), toNextFrame);
+
+            if(system.getTimeToEnd(instance) != toEnd)
+                return fail(elapsed, "time to end", system.getTimeToEnd(instance), toEnd);
+        }
+
+        system.destroy(instance);
+
+        return true;
+    }
+}
+
+int main()
+{
+    AnimationSystem system;
+
+    int runs     = 0;
+    int failures = 0;
+
+    for(const auto& test : Cases)
+    {
+        const std::string name = "clip" + std::to_string(runs);
+        const auto        clip = system.addClip(name, { 10U, test.duration, test.delay });
+
+        for(int flags = 0; flags < 4; ++flags)
+        {
+            failures += run(system, clip, test, (flags & 1) != 0, (flags & 2) != 0) ? 0 : 1;
+            ++runs;
+        }
+    }
+
+    std::cout << runs - failures << " of " << runs << " animation runs match the closed form\n";
+
+    return failures;
+}
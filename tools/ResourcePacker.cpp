@@ -0,0 +1,168 @@
+// Packs a resource directory into a single archive readable by ResourcePack.
+// Usage: ResourcePacker <resource folder> <output pack> [--no-compress] [--align N]
+
+#include <filesystem>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "system/ResourcePack.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+//  Formats that are already compressed gain nothing from zlib
+    bool isCompressible(const fs::path& path) noexcept
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        return extension != ".png" && extension != ".jpg" && extension != ".jpeg";
+    }
+
+    std::vector<char> readFile(const fs::path& path) noexcept
+    {
+        std::ifstream file(path, std::ios::binary);
+
+        return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    void pad(std::ofstream& out, std::uint64_t& offset, std::uint32_t alignment) noexcept
+    {
+        static const char zeros[4096] {};
+
+        const std::uint64_t aligned = (offset + alignment - 1) / alignment * alignment;
+        out.write(zeros, static_cast<std::streamsize>(aligned - offset));
+        offset = aligned;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: ResourcePacker <resource folder> <output pack> [--no-compress] [--align N]\n";
+        return 1;
+    }
+
+    const fs::path root   = argv[1];
+    const fs::path output = argv[2];
+
+    bool          compress  = true;
+    std::uint32_t alignment = 64U;
+
+    for (int i = 3; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--no-compress") == 0)
+            compress = false;
+        else if (std::strcmp(argv[i], "--align") == 0 && i + 1 < argc)
+            alignment = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+    }
+
+    if (alignment == 0U || alignment > 4096U || (alignment & (alignment - 1U)) != 0U)
+    {
+        std::cerr << "Error: alignment must be a power of two not greater than 4096\n";
+        return 1;
+    }
+
+    std::vector<fs::path> files;
+
+    for (auto& file : fs::recursive_directory_iterator(root))
+        if (file.is_regular_file())
+            files.push_back(file.path());
+
+//  A stable order keeps the pack reproducible between builds
+    std::sort(files.begin(), files.end());
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+
+    if (!out)
+    {
+        std::cerr << "Error: can not create " << output.string() << '\n';
+        return 1;
+    }
+
+    ResourcePack::Header header;
+    header.entryCount = static_cast<std::uint32_t>(files.size());
+    header.alignment  = alignment;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<ResourcePack::Entry> entries;
+    std::string names;
+    std::uint64_t offset = sizeof(header);
+    std::uint64_t totalOriginal = 0U;
+
+    entries.reserve(files.size());
+
+    for (const auto& path : files)
+    {
+        std::vector<char> data = readFile(path);
+        std::string name = fs::relative(path, root).generic_string();
+
+        auto& entry = entries.emplace_back();
+        entry.originalSize = data.size();
+        entry.nameOffset   = static_cast<std::uint32_t>(names.size());
+        entry.nameLength   = static_cast<std::uint32_t>(name.size());
+        names += name;
+
+        const char* bytes = data.data();
+        std::size_t size  = data.size();
+        unsigned char* packed = nullptr;
+
+        if (compress && !data.empty() && isCompressible(path))
+        {
+            int packedSize = 0;
+            packed = stbi_zlib_compress(reinterpret_cast<unsigned char*>(data.data()), static_cast<int>(data.size()), &packedSize, 8);
+
+//          Keep the compressed form only when it pays off
+            if (packed && static_cast<std::size_t>(packedSize) < size - size / 8)
+            {
+                bytes = reinterpret_cast<const char*>(packed);
+                size  = static_cast<std::size_t>(packedSize);
+                entry.flags |= ResourcePack::Compressed;
+            }
+        }
+
+        pad(out, offset, alignment);
+
+        entry.offset = offset;
+        entry.size   = size;
+
+        out.write(bytes, static_cast<std::streamsize>(size));
+        offset += size;
+        totalOriginal += data.size();
+
+        if (packed)
+            free(packed);
+    }
+
+    pad(out, offset, alignof(ResourcePack::Entry));
+    header.tocOffset = offset;
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(sizeof(ResourcePack::Entry) * entries.size()));
+    offset += sizeof(ResourcePack::Entry) * entries.size();
+
+    header.namesOffset = offset;
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!out)
+    {
+        std::cerr << "Error: failed to write " << output.string() << '\n';
+        return 1;
+    }
+
+    std::cout << "Packed " << files.size() << " files (" << totalOriginal << " bytes) into " << output.string() << '\n';
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+// Reports the fill rate SpriteManager saves by trimming the frames of a sprite sheet, per animation and for the sheet.
+// Usage: SpriteTrimReport <sprite sheet.xml> [--max-vertices N]
+//        SpriteTrimReport <image> <columns> <rows> [--max-vertices N]
+// A sheet names its image in the image attribute of <sprites>, relative to the sheet. The frames are cut and traced
+// as SpriteManager::loadSpriteSheet and createGridAnimaton do with TrimOptions.
+
+#include <filesystem>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "rapidxml.hpp"
+
+#include "graphics/Image.hpp"
+#include "graphics/SpriteOutline.hpp"
+#include "managers/SpriteManager.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    struct Cut
+    {
+        std::string             title;
+        std::vector<glm::ivec4> frames; // x, y, width, height
+    };
+
+    void trace(const Image& image, const Cut& cut, unsigned maxVertices, SpriteManager::TrimStatistics& statistics) noexcept
+    {
+        for(const auto& frame : cut.frames)
+        {
+            SpriteOutline outline;
+
+            if(!outline.build(image, frame, maxVertices))
+            {
+                std::cerr << "Warning: a frame of " << cut.title << " is outside the image, counted as a quad\n";
+                outline.setQuad(static_cast<unsigned>(frame.z), static_cast<unsigned>(frame.w));
+            }
+
+            statistics.frames        += 1U;
+            statistics.polygons      += outline.count > 4U ? 1U : 0U;
+            statistics.quadPixels    += std::uint64_t(frame.z) * frame.w;
+            statistics.outlinePixels += outline.area;
+        }
+    }
+
+    void print(const std::string& name, const SpriteManager::TrimStatistics& statistics) noexcept
+    {
+        const double fill = statistics.quadPixels ? 100.0 * statistics.outlinePixels / statistics.quadPixels : 100.0;
+
+        std::cout << name << ": " << statistics.polygons << " of " << statistics.frames << " frames trimmed, "
+                  << statistics.outlinePixels << " of " << statistics.quadPixels << " pixels, fill rate " << fill << "% of the quads\n";
+    }
+
+    bool readSheet(const fs::path& path, fs::path& imagePath, std::vector<Cut>& cuts) noexcept
+    {
+        std::ifstream file(path, std::ios::binary);
+
+        if(!file)
+            return false;
+
+        std::vector<char> xmlText((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        xmlText.push_back('\0');
+
+        rapidxml::xml_document<char> document;
+        document.parse<0>(xmlText.data());
+
+        const auto spriteNode = document.first_node("sprites");
+        const auto image      = spriteNode ? spriteNode->first_attribute("image") : nullptr;
+
+        if(!image)
+            return false;
+
+        imagePath = path.parent_path() / image->value();
+
+        for(auto animNode = spriteNode->first_node("animation"); animNode != nullptr; animNode = animNode->next_sibling("animation"))
+        {
+            auto pTitle = animNode->first_attribute("title");
+
+            if(!pTitle || *pTitle->value() == '\0')
+                continue;
+
+            Cut& cut  = cuts.emplace_back();
+            cut.title = pTitle->value();
+
+            for(auto cutNode = animNode->first_node("cut"); cutNode != nullptr; cutNode = cutNode->next_sibling())
+            {
+                auto getInt = [cutNode](const char* name)
+                {
+                    auto attribute = cutNode->first_attribute(name);
+
+                    return attribute ? std::atoi(attribute->value()) : 0;
+                };
+
+                cut.frames.emplace_back(getInt("x"), getInt("y"), getInt("w"), getInt("h"));
+            }
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    unsigned maxVertices = SpriteOutline::MaxVertices;
+
+    for(std::size_t i = 0; i < args.size(); ++i)
+    {
+        if(args[i] == "--max-vertices" && i + 1 < args.size())
+        {
+            maxVertices = static_cast<unsigned>(std::strtoul(args[i + 1].c_str(), nullptr, 10));
+            args.erase(args.begin() + static_cast<std::ptrdiff_t>(i), args.begin() + static_cast<std::ptrdiff_t>(i + 2));
+            break;
+        }
+    }
+
+    if((args.size() != 1U && args.size() != 3U) || maxVertices < 3U || maxVertices > SpriteOutline::MaxVertices)
+    {
+        std::cerr << "Usage: SpriteTrimReport <sprite sheet.xml> [--max-vertices N]\n"
+                     "       SpriteTrimReport <image> <columns> <rows> [--max-vertices N]\n";
+        return 1;
+    }
+
+    fs::path         imagePath;
+    std::vector<Cut> cuts;
+
+    if(args.size() == 1U)
+    {
+        if(!readSheet(args[0], imagePath, cuts))
+        {
+            std::cerr << "Error: " << args[0] << " is not a sprite sheet\n";
+            return 1;
+        }
+    }
+    else
+        imagePath = args[0];
+
+    Image image;
+
+    if(!image.loadFromFile(imagePath.string()))
+        return 1;
+
+//  A grid splits the whole image, as createGridAnimaton does
+    if(args.size() == 3U)
+    {
+        const int columns = std::atoi(args[1].c_str());
+        const int rows    = std::atoi(args[2].c_str());
+
+        if(columns <= 0 || rows <= 0)
+        {
+            std::cerr << "Error: the grid needs at least one column and one row\n";
+            return 1;
+        }
+
+        const int width  = static_cast<int>(image.getSize().x) / columns;
+        const int height = static_cast<int>(image.getSize().y) / rows;
+
+        Cut& cut  = cuts.emplace_back();
+        cut.title = imagePath.filename().string();
+
+        for(int y = 0; y < rows; ++y)
+            for(int x = 0; x < columns; ++x)
+                cut.frames.emplace_back(x * width, y * height, width, height);
+    }
+
+    SpriteManager::TrimStatistics total;
+
+    for(const auto& cut : cuts)
+    {
+        SpriteManager::TrimStatistics statistics;
+        trace(image, cut, maxVertices, statistics);
+
+        if(cuts.size() > 1U)
+            print("  " + cut.title, statistics);
+
+        total.frames        += statistics.frames;
+        total.polygons      += statistics.polygons;
+        total.quadPixels    += statistics.quadPixels;
+        total.outlinePixels += statistics.outlinePixels;
+    }
+
+    print(args[0], total);
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+// Schedules timers on every level of TimerWheel and beyond its horizon, one-shot and periodic, cancels them
+// before and during advance(), from other callbacks and from their own, and checks every callback against
+// a model: each timer fires exactly at its expiry tick, periodic ones every period after, cancelled ones never.
+// Runs with a tick of one and of three milliseconds. Returns the number of failures, run by ctest as timer_wheel.
+
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "system/TimerWheel.hpp"
+
+namespace
+{
+    constexpr std::uint64_t Never   = UINT64_MAX;
+    constexpr std::uint64_t Horizon = std::uint64_t(1) << (TimerWheel::SlotBits * TimerWheel::Levels);
+
+//  Delays in ticks: within the first level, each upper level, and past the horizon
+    constexpr std::uint64_t Ranges[][2] =
+    {
+        { 0U, 64U },
+        { 64U, 4096U },
+        { 4096U, 262144U },
+        { 262144U, Horizon },
+        { Horizon, 4U * Horizon }
+    };
+
+    struct Expected
+    {
+        TimerWheel::TimerId id        = TimerWheel::InvalidTimer;
+        std::uint64_t       expiry    = Never; // Next tick it fires at
+        std::uint64_t       period    = 0U;    // In ticks
+        std::uint32_t       fired     = 0U;
+        std::uint32_t       maxFired  = 0U;    // Cancels itself from its callback after that many, 0 for never
+        bool                cancelled = false;
+    };
+
+    class Run
+    {
+    public:
+        Run(unsigned tickLength, std::uint64_t seed) :
+            m_wheel(tickLength),
+            m_random(seed),
+            m_tickLength(tickLength)
+        {
+        }
+
+        int play()
+        {
+            for(int i = 0; i < 2000; ++i)
+                schedule();
+
+//          Some are cancelled before the clock moves at all
+            for(int i = 0; i < 200; ++i)
+                cancelRandom();
+
+            const std::uint64_t end = 4U * Horizon + 100000U;
+
+            while(m_wheel.getTime() < end)
+            {
+//              Mostly short steps, sometimes long jumps over whole rounds of the upper levels
+                const int dt = (m_random() % 8U == 0U) ? static_cast<int>(m_random() % (1U << 22)) : static_cast<int>(m_random() % 5000U) + 1;
+
+                m_wheel.advance(dt);
+
+                if(m_random() % 4U == 0U)
+                    cancelRandom();
+            }
+
+//          Whatever was due by now has fired, what is left is still pending
+            for(std::size_t k = 0; k < m_timers.size(); ++k)
+            {
+                const Expected& timer     = m_timers[k];
+                const bool      isPending = !timer.cancelled && timer.expiry != Never;
+
+                if(isPending && timer.expiry <= m_wheel.getTime())
+                    fail(k, "never fired, due at", timer.expiry);
+
+                if(m_wheel.isPending(timer.id) != isPending)
+                    fail(k, "pending state differs at", m_wheel.getTime());
+            }
+
+            std::cout << "tick " << m_tickLength << " ms: " << m_timers.size() << " timers, " << m_firings << " firings, "
+                      << m_wheel.getStatistics().cascaded << " cascades, " << m_failures << " failures\n";
+
+            return m_failures;
+        }
+
+    private:
+        void schedule()
+        {
+            const auto&         range  = Ranges[m_random() % std::size(Ranges)];
+            const std::uint64_t delay  = range[0] + m_random() % (range[1] - range[0]);
+            const std::uint64_t kind   = m_random() % 4U;
+
+            Expected timer;
+
+//          One in four is periodic: either with a long period, or a short one and cancelling itself after a few firings
+            if(kind == 0U)
+                timer.period = Ranges[2U + m_random() % 3U][0] + m_random() % Horizon;
+            else if(kind == 1U)
+            {
+                timer.period   = 1U + m_random() % 200U;
+                timer.maxFired = 1U + static_cast<std::uint32_t>(m_random() % 50U);
+            }
+
+            const std::size_t k = m_timers.size();
+
+//          In milliseconds, rounded up to ticks by the wheel: the model does the same
+            const std::uint64_t delayMs  = delay ? delay * m_tickLength - (m_random() % m_tickLength) : 0U;
+            const std::uint64_t periodMs = timer.period ? timer.period * m_tickLength - (m_random() % m_tickLength) : 0U;
+
+            timer.expiry = m_wheel.getTime() + std::max<std::uint64_t>((delayMs + m_tickLength - 1U) / m_tickLength, 1U);
+            timer.id     = m_wheel.schedule(delayMs, [this, k](TimerWheel::TimerId id) { onFire(k, id); }, periodMs);
+
+            m_timers.push_back(timer);
+        }
+
+        void onFire(std::size_t k, TimerWheel::TimerId id)
+        {
+            ++m_firings;
+
+            if(id != m_timers[k].id)
+                fail(k, "fired with another id at", m_wheel.getTime());
+
+            if(m_timers[k].cancelled)
+                fail(k, "fired after being cancelled at", m_wheel.getTime());
+
+            if(m_wheel.getTime() != m_timers[k].expiry)
+                fail(k, "fired at", m_wheel.getTime());
+
+            if(m_wheel.getTime() < m_lastFiring)
+                fail(k, "fired out of order at", m_wheel.getTime());
+
+            m_lastFiring = m_wheel.getTime();
+
+            Expected& timer = m_timers[k];
+            ++timer.fired;
+            timer.expiry = timer.period ? timer.expiry + timer.period : Never;
+
+            if(timer.maxFired && timer.fired == timer.maxFired)
+                cancel(k);
+
+//          Callbacks also cancel other timers and schedule new ones, while the wheel is ticking
+            if(m_random() % 16U == 0U)
+                cancelRandom();
+
+            if(m_random() % 8U == 0U && m_timers.size() < 6000U)
+                schedule();
+        }
+
+        void cancelRandom()
+        {
+            if(!m_timers.empty())
+                cancel(m_random() % m_timers.size());
+        }
+
+        void cancel(std::size_t k)
+        {
+            Expected&  timer     = m_timers[k];
+            const bool isPending = !timer.cancelled && timer.expiry != Never;
+
+            if(m_wheel.cancel(timer.id) != isPending)
+                fail(k, "cancel disagrees with the model at", m_wheel.getTime());
+
+            timer.cancelled = timer.cancelled || isPending;
+        }
+
+        void fail(std::size_t k, const char* what, std::uint64_t tick)
+        {
+            if(++m_failures <= 20)
+                std::cerr << "FAIL tick " << m_tickLength << " ms, timer " << k << " (period " << m_timers[k].period
+                          << ", expected at " << m_timers[k].expiry << ") " << what << ' ' << tick << '\n';
+        }
+
+    private:
+        TimerWheel            m_wheel;
+        std::mt19937_64       m_random;
+        std::vector<Expected> m_timers;
+        std::uint64_t         m_tickLength;
+        std::uint64_t         m_firings    = 0U;
+        std::uint64_t         m_lastFiring = 0U;
+        int                   m_failures   = 0;
+    };
+}
+
+int main()
+{
+    int failures = 0;
+
+    failures += Run(1U, 1U).play();
+    failures += Run(3U, 2U).play();
+
+    return failures;
+}
@@ -0,0 +1,163 @@
+// Times the transform paths against each other: Transform2D::getMatrix per object, TransformSystem::update
+// on the calling thread, and TransformSystem::update on a thread pool. After each update every affine is checked
+// against Transform2D::getMatrix, and the largest absolute error of each axis and translation component is
+// reported. Returns 1 when one is above its tolerance, run by ctest as transform_accuracy.
+// Usage: TransformBenchmark [transform count] [rounds]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include <cmath>
+
+#include "system/ThreadPool.hpp"
+#include "graphics/Transform2D.hpp"
+#include "graphics/TransformSystem.hpp"
+
+namespace
+{
+    double elapsedSince(std::chrono::steady_clock::time_point start) noexcept
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+//  The axes are at most the scale of 0.5, a few ulps of the polynomial sine and cosine is well below 1e-5.
+//  The translations reach 1000 units, where a float is 6e-5 coarse
+    constexpr float AxisTolerance        = 1e-5f;
+    constexpr float TranslationTolerance = 1e-3f;
+
+    constexpr const char* Components[] = { "axisX.x", "axisX.y", "axisY.x", "axisY.y", "translation.x", "translation.y" };
+
+    struct Errors
+    {
+        float max[6] = {};
+    };
+
+//  Largest absolute difference of each component of the system's affines to the matrices of the objects
+    void measure(const std::vector<Transform2D>& objects, const std::vector<TransformSystem::Transform>& transforms,
+                 const TransformSystem& system, Errors& errors) noexcept
+    {
+        for(std::size_t i = 0; i < objects.size(); ++i)
+        {
+            const glm::mat4& matrix = objects[i].getMatrix();
+            const Affine2D&  affine = system.getAffine(transforms[i]);
+
+            const float differences[6] =
+            {
+                affine.axisX.x - matrix[0].x,       affine.axisX.y - matrix[0].y,
+                affine.axisY.x - matrix[1].x,       affine.axisY.y - matrix[1].y,
+                affine.translation.x - matrix[3].x, affine.translation.y - matrix[3].y
+            };
+
+            for(int k = 0; k < 6; ++k)
+                errors.max[k] = std::fmax(errors.max[k], std::fabs(differences[k]));
+        }
+    }
+
+    bool report(const char* name, const Errors& errors) noexcept
+    {
+        bool isAccurate = true;
+
+        std::cout << "  " << name << " max error:";
+
+        for(int k = 0; k < 6; ++k)
+        {
+            std::cout << ' ' << Components[k] << ' ' << errors.max[k];
+            isAccurate = isAccurate && errors.max[k] <= (k < 4 ? AxisTolerance : TranslationTolerance);
+        }
+
+        std::cout << '\n';
+
+        return isAccurate;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t count  = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000U;
+    const int         rounds = (argc > 2) ? std::atoi(argv[2]) : 20;
+
+    if(count == 0U || rounds <= 0)
+    {
+        std::cerr << "Usage: TransformBenchmark [transform count] [rounds]\n";
+        return 1;
+    }
+
+    ThreadPool pool;
+
+    std::vector<Transform2D>                objects(count);
+    std::vector<TransformSystem::Transform> transforms;
+    TransformSystem                         system;
+
+    transforms.reserve(count);
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const float x = static_cast<float>(i % 1000U);
+        const float y = static_cast<float>(i / 1000U);
+
+        objects[i].setPosition(x, y)->setOrigin(16.0f, 16.0f)->setScale(0.5f);
+
+        const auto transform = system.create();
+        system.setPosition(transform, x, y);
+        system.setOrigin(transform, 16.0f, 16.0f);
+        system.setScale(transform, 0.5f, 0.5f);
+        transforms.push_back(transform);
+    }
+
+//  Every transform changes each round, only the matrix computations are timed. Both updates recompute every
+//  affine from the same rotations as the objects, and are checked against them
+    double perObject = 0.0;
+    double batched   = 0.0;
+    double parallel  = 0.0;
+    float  checksum  = 0.0f; // Keeps the timed getMatrix calls from being optimized out
+    Errors batchedErrors;
+    Errors parallelErrors;
+
+    for(int round = 0; round < rounds; ++round)
+    {
+        for(std::size_t i = 0; i < count; ++i)
+            objects[i].setRotation(static_cast<float>(round + i));
+
+        auto start = std::chrono::steady_clock::now();
+
+        for(const auto& object : objects)
+            checksum += object.getMatrix()[3].x;
+
+        perObject += elapsedSince(start);
+
+        for(std::size_t i = 0; i < count; ++i)
+            system.setRotation(transforms[i], static_cast<float>(round + i));
+
+        start = std::chrono::steady_clock::now();
+        system.update();
+        batched += elapsedSince(start);
+
+        measure(objects, transforms, system, batchedErrors);
+
+        for(std::size_t i = 0; i < count; ++i)
+            system.setRotation(transforms[i], static_cast<float>(round + i));
+
+        start = std::chrono::steady_clock::now();
+        system.update(pool);
+        parallel += elapsedSince(start);
+
+        measure(objects, transforms, system, parallelErrors);
+    }
+
+    std::cout << count << " transforms: Transform2D::getMatrix " << perObject / rounds << " ms, TransformSystem ("
+              << TransformSystem::getInstructionSet() << ") " << batched / rounds << " ms, on " << pool.getThreadCount() + 1U
+              << " threads " << parallel / rounds << " ms (checksum " << checksum << ")\n";
+
+    const bool isBatchedAccurate  = report("TransformSystem::update", batchedErrors);
+    const bool isParallelAccurate = report("TransformSystem::update(pool)", parallelErrors);
+
+    if(!isBatchedAccurate || !isParallelAccurate)
+    {
+        std::cerr << "Error: the TransformSystem affines differ from Transform2D::getMatrix by more than "
+                  << AxisTolerance << " on an axis or " << TranslationTolerance << " on a translation\n";
+        return 1;
+    }
+
+    return 0;
+}